@@ -8,6 +8,31 @@ os.chdir(script_dir)
 
 memory_end_address = 2 ** (cfg.RAM_ADDRESS_BITWIDTH + cfg.RAM_ADDRESSING_MODE)
 
+# memory mapped I/O ports at the top of the address space
+#  name, address, type in 'os_config.hpp'
+#  note: 'src/top.sv' passes the addresses in 'configuration.sv' to 'ramio'
+io_ports = [
+    ("LED", 0xFFFF_FFFC, "unsigned"),
+    ("UART_OUT", 0xFFFF_FFF8, "int"),
+    ("UART_IN", 0xFFFF_FFF4, "int"),
+    ("SDCARD_BUSY", 0xFFFF_FFF0, "int"),
+    ("SDCARD_READ_SECTOR", 0xFFFF_FFEC, "unsigned"),
+    ("SDCARD_NEXT_BYTE", 0xFFFF_FFE8, "int"),
+    ("SDCARD_STATUS", 0xFFFF_FFE4, "unsigned"),
+    ("SDCARD_WRITE_SECTOR", 0xFFFF_FFE0, "unsigned"),
+    ("SDCARD_NEXT_WORD", 0xFFFF_FFDC, "unsigned"),
+]
+io_addresses_start = min(address for _, address, _ in io_ports)
+
+
+def cpp_hex(value):
+    return f"0x{value >> 16:04x}'{value & 0xFFFF:04x}"
+
+
+def sv_hex(value):
+    return f"32'h{value >> 16:04x}_{value & 0xFFFF:04x}"
+
+
 with open("os/src/os_start.S", "w") as file:
     file.write("# generated - do not edit (see `configuration.py`)\n")
     file.write(".global _start\n")
@@ -18,14 +43,8 @@ with open("os/src/os_start.S", "w") as file:
 with open("os/src/os_config.hpp", "w") as file:
     file.write("// generated - do not edit (see `configuration.py`)\n")
     file.write("#pragma once\n")
-    file.write("#define LED ((unsigned volatile *)0xffff'fffc)\n")
-    file.write("#define UART_OUT ((int volatile *)0xffff'fff8)\n")
-    file.write("#define UART_IN ((int volatile *)0xffff'fff4)\n")
-    file.write("#define SDCARD_BUSY ((int volatile *)0xffff'fff0)\n")
-    file.write("#define SDCARD_READ_SECTOR ((unsigned volatile *)0xffff'ffec)\n")
-    file.write("#define SDCARD_NEXT_BYTE ((int volatile *)0xffff'ffe8)\n")
-    file.write("#define SDCARD_STATUS ((unsigned volatile *)0xffff'ffe4)\n")
-    file.write("#define SDCARD_WRITE_SECTOR ((unsigned volatile *)0xffff'ffe0)\n")
+    for name, address, c_type in io_ports:
+        file.write(f"#define {name} (({c_type} volatile *){cpp_hex(address)})\n")
     file.write(f"#define MEMORY_END {hex(memory_end_address)}\n")
 
 with open("emulator/src/main_config.hpp", "w") as file:
@@ -34,16 +53,23 @@ with open("emulator/src/main_config.hpp", "w") as file:
     file.write("#include <cstdint>\n\n")
     file.write("namespace osqa {\n\n")
     file.write("// memory map\n")
-    file.write("std::uint32_t constexpr led = 0xffff'fffc;\n")
-    file.write("std::uint32_t constexpr uart_out = 0xffff'fff8;\n")
-    file.write("std::uint32_t constexpr uart_in = 0xffff'fff4;\n")
-    file.write("std::uint32_t constexpr sdcard_busy = 0xffff'fff0;\n")
-    file.write("std::uint32_t constexpr sdcard_read_sector = 0xffff'ffec;\n")
-    file.write("std::uint32_t constexpr sdcard_next_byte = 0xffff'ffe8;\n")
-    file.write("std::uint32_t constexpr sdcard_status = 0xffff'ffe4;\n")
-    file.write("std::uint32_t constexpr sdcard_write_sector = 0xffff'ffe0;\n")
-    file.write("std::uint32_t constexpr io_addresses_start = 0xffff'ffe0;\n")
+    for name, address, _ in io_ports:
+        file.write(
+            f"std::uint32_t constexpr {name.lower()} = {cpp_hex(address)};\n"
+        )
+    file.write(
+        f"std::uint32_t constexpr io_addresses_start = {cpp_hex(io_addresses_start)};\n"
+    )
     file.write(f"std::uint32_t constexpr memory_end = {hex(memory_end_address)};\n")
+    file.write("\n// cache\n")
+    file.write(
+        f"std::uint32_t constexpr cache_column_index_bitwidth = {cfg.CACHE_COLUMN_INDEX_BITWIDTH};\n"
+    )
+    file.write(
+        f"std::uint32_t constexpr cache_line_index_bitwidth = {cfg.CACHE_LINE_INDEX_BITWIDTH};\n"
+    )
+    file.write("\n// CPU\n")
+    file.write(f"std::uint32_t constexpr cpu_frequency_hz = {cfg.CPU_FREQUENCY_HZ};\n")
     file.write("\n} // namespace osqa\n")
 
 with open("src/configuration.sv", "w") as file:
@@ -68,6 +94,9 @@ with open("src/configuration.sv", "w") as file:
         f"  parameter int unsigned CACHE_LINE_INDEX_BITWIDTH = {cfg.CACHE_LINE_INDEX_BITWIDTH};\n"
     )
     file.write(f"  parameter int unsigned UART_BAUD_RATE = {cfg.UART_BAUD_RATE};\n")
+    file.write(
+        f"  parameter int unsigned UART_RX_FIFO_DEPTH_BITWIDTH = {cfg.UART_RX_FIFO_DEPTH_BITWIDTH};\n"
+    )
     file.write(
         f"  parameter int unsigned FLASH_TRANSFER_FROM_ADDRESS = 32'h{cfg.FLASH_TRANSFER_FROM_ADDRESS:08x};\n"
     )
@@ -78,6 +107,14 @@ with open("src/configuration.sv", "w") as file:
         f"  parameter int unsigned STARTUP_WAIT_CYCLES = {cfg.STARTUP_WAIT_CYCLES};\n"
     )
     file.write("\n")
+    for name, address, _ in io_ports:
+        file.write(
+            f"  parameter int unsigned ADDRESS_{name} = {sv_hex(address)};\n"
+        )
+    file.write(
+        f"  parameter int unsigned ADDRESS_IO_PORTS_START = {sv_hex(io_addresses_start)};\n"
+    )
+    file.write("\n")
     file.write("endpackage\n")
 
 with open(cfg.BOARD_NAME + ".sdc", "w") as file:
@@ -25,6 +25,11 @@ RAM_ADDRESSING_MODE = 2
 UART_BAUD_RATE = 115200
 # 115200 baud, 8 bits, 1 stop bit, no parity
 
+UART_RX_FIFO_DEPTH_BITWIDTH = 0
+# 0: one received byte that is overrun by the next
+# n: 2 ^ n received bytes queued until read, e.g. 4 for 16 bytes
+# note: 'qa/11' tests the FIFO; 0 until synthesis confirms it fits
+
 CACHE_COLUMN_INDEX_BITWIDTH = 3
 # 2 ^ 3 = 8 entries (32 B) per cache line
 # hardcoded. setting has no effect.
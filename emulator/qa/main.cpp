@@ -1,11 +1,12 @@
+#include "../src/mapped_file.hpp"
 #include "../src/rv32i.hpp"
-#include <fstream>
-#include <vector>
+#include <cstdlib>
+#include <iterator>
 
 using namespace std;
 
-// initialize RAM with -1 being the default value from flash
-static vector<uint8_t> ram(8 * 1024, 0xff);
+// RAM initialized from firmware with -1 being the default value from flash
+static mapped_file ram;
 
 // bus callback
 static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
@@ -25,43 +26,28 @@ static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
   return 0;
 }
 
-static auto load_file(char const *file_name, char const *data_name,
-                      vector<uint8_t> &data) -> bool {
-
-  ifstream file{file_name, ios::binary | ios::ate};
-  if (!file) {
-    printf("%s: error opening file '%s'\n", data_name, file_name);
-    return false;
-  }
-
-  streamsize const size = file.tellg();
-  if (size == -1) {
-    printf("%s: error determining size of file '%s'\n", data_name, file_name);
-    return false;
-  }
-
-  if (size > streamsize(data.size())) {
-    printf("%s: size of file (%zu B) exceeds size of data container (%zu B)\n",
-           data_name, size, data.size());
-    return false;
+// bus model inlined in the cpu
+//  note: the self-modifying code test uses 'bus' through 'callback_bus'
+struct test_bus final {
+  auto load(uint32_t const address, rv32i::bus_op_width const op_width,
+            uint32_t &data) -> rv32i::bus_status {
+    if (address >= ram.size()) {
+      // input device without data
+      data = 0xffff'ffff;
+      return rv32i::BUS_IO_WAIT;
+    }
+    return bus(address, op_width, false, data);
   }
 
-  file.seekg(0, ios::beg);
-  if (file.fail()) {
-    printf("%s: error seeking to beginning of file '%s'\n", data_name,
-           file_name);
-    return false;
+  auto store(uint32_t const address, rv32i::bus_op_width const op_width,
+             uint32_t data) -> rv32i::bus_status {
+    return bus(address, op_width, true, data);
   }
 
-  if (!file.read(reinterpret_cast<char *>(data.data()), size)) {
-    printf("%s: error reading file '%s'\n", data_name, file_name);
-    return false;
+  auto fetch(uint32_t const address, uint32_t &data) -> rv32i::bus_status {
+    return bus(address, rv32i::bus_op_width::WORD, false, data);
   }
-
-  file.close();
-
-  return true;
-}
+};
 
 auto assert(bool const condition, int32_t const test_number) -> void {
   if (!condition) {
@@ -72,13 +58,13 @@ auto assert(bool const condition, int32_t const test_number) -> void {
 
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
 
-  if (!load_file("ram.bin", "Firmware", ram)) {
+  if (!ram.map_filled("ram.bin", "Firmware", 8 * 1024, 0xff)) {
     return 1;
   }
 
   // run CPU
 
-  rv32i::cpu cpu{bus};
+  rv32i::cpu cpu{test_bus{}, ram.data(), uint32_t(ram.size())};
 
   // 0: 00000013 addi x0,x0,0
   cpu.tick();
@@ -336,5 +322,78 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
   cpu.tick();
   assert(cpu.pc() == 0xd8, 58);
 
+  // self-modifying code: store over an executed instruction
+  uint32_t const self_modifying[] = {
+      0x0010'0293, // 1800: addi x5,x0,1
+      0x0003'1e63, // 1804: bne x6,x0,1820
+      0x0010'0313, // 1808: addi x6,x0,1
+      0x0000'2437, // 180c: lui x8,0x2
+      0x8244'2383, // 1810: lw x7,-2012(x8) # x7 = [1824]
+      0x8074'2023, // 1814: sw x7,-2048(x8) # [1800] = x7
+      0xfe9f'f06f, // 1818: jal x0,1800
+      0x0000'0013, // 181c: addi x0,x0,0
+      0x0000'006f, // 1820: jal x0,1820
+      0x0020'0293, // 1824: addi x5,x0,2
+  };
+  for (uint32_t i = 0; i < size(self_modifying); ++i) {
+    for (uint32_t j = 0; j < 4; ++j) {
+      ram[0x1800 + i * 4 + j] = uint8_t(self_modifying[i] >> (j * 8));
+    }
+  }
+
+  rv32i::cpu cpu_self_modifying{bus, ram.data(), uint32_t(ram.size()), 0x1800};
+
+  cpu_self_modifying.run(100);
+  assert(cpu_self_modifying.pc() == 0x1820, 59);
+  assert(cpu_self_modifying.reg(5) == 2, 60);
+
+  // load waiting for I/O retires and stops 'run'
+  uint32_t const io_wait[] = {
+      0x0010'0313, // 1828: addi x6,x0,1
+      0xffc0'2303, // 182c: lw x6,-4(x0)
+      0x0000'006f, // 1830: jal x0,1830
+  };
+  for (uint32_t i = 0; i < size(io_wait); ++i) {
+    for (uint32_t j = 0; j < 4; ++j) {
+      ram[0x1828 + i * 4 + j] = uint8_t(io_wait[i] >> (j * 8));
+    }
+  }
+
+  rv32i::cpu cpu_io_wait{test_bus{}, ram.data(), uint32_t(ram.size()), 0x1828};
+
+  rv32i::run_result const r = cpu_io_wait.run(100);
+  assert(r.reason == rv32i::stop_reason::IO_WAIT, 61);
+  assert(r.executed == 2, 62);
+  assert(cpu_io_wait.pc() == 0x1830, 63);
+  assert(cpu_io_wait.reg(6) == -1, 64);
+
+  // self-modifying code: store over an instruction whose decoded instruction
+  // cache entry was evicted by an aliasing instruction in the same superblock
+  uint32_t const aliasing[][2] = {
+      {0x0'0000, 0x0001'006f}, // 0: jal x0,10000
+      {0x0'0004, 0x0141'006f}, // 4: jal x0,10018
+      {0x1'0000, 0x0003'1c63}, // 10000: bne x6,x0,10018
+      {0x1'0004, 0x0010'0313}, // 10004: addi x6,x0,1
+      {0x1'0008, 0x0001'0437}, // 10008: lui x8,0x10
+      {0x1'000c, 0x01c4'2383}, // 1000c: lw x7,28(x8) # x7 = [1001c]
+      {0x1'0010, 0x0070'2023}, // 10010: sw x7,0(x0) # [0] = x7
+      {0x1'0014, 0xfede'f06f}, // 10014: jal x0,0
+      {0x1'0018, 0x0000'006f}, // 10018: jal x0,10018
+      {0x1'001c, 0x0020'0293}, // 1001c: addi x5,x0,2
+  };
+  static uint8_t aliasing_ram[0x2'0000];
+  for (auto const [address, instruction] : aliasing) {
+    for (uint32_t j = 0; j < 4; ++j) {
+      aliasing_ram[address + j] = uint8_t(instruction >> (j * 8));
+    }
+  }
+
+  rv32i::cpu cpu_aliasing{test_bus{}, aliasing_ram,
+                          uint32_t(size(aliasing_ram))};
+
+  cpu_aliasing.run(100);
+  assert(cpu_aliasing.pc() == 0x1'0018, 65);
+  assert(cpu_aliasing.reg(5) == 2, 66);
+
   return 0;
 }
\ No newline at end of file
@@ -14,14 +14,14 @@ CMD="g++ -std=c++23 -O3 -fno-rtti -fno-exceptions -Wfatal-errors -Werror -Wall -
     -Wconversion -Wsign-conversion -Wswitch-default -Wimplicit-fallthrough \
     -Wshadow -Wlogical-op -Wnon-virtual-dtor -Wcast-align -Woverloaded-virtual \
     -Wduplicated-cond -Wduplicated-branches -Wnull-dereference -Wuseless-cast \
-    -Wdouble-promotion -Wmisleading-indentation -Wformat=2 \
-    -o osqa-test main.cpp"
+    -Wdouble-promotion -Wmisleading-indentation -Wformat=2"
 #echo
 #echo $CMD
 #echo
-$CMD
+$CMD -o osqa-test main.cpp
+$CMD -DRV32I_THREADED -o osqa-test-threaded main.cpp
 
-ls -l --color osqa-test
+ls -l --color osqa-test osqa-test-threaded
 
 #
 # compile test cases
@@ -54,6 +54,9 @@ $OBJDUMP -Mnumeric,no-aliases -dr $BIN > $BIN.lst
 
 rm $BIN
 
+echo " * interpreter"
 ./osqa-test
+echo " * threaded"
+./osqa-test-threaded
 
 echo "test: PASSED"
\ No newline at end of file
@@ -0,0 +1,161 @@
+//
+// model of the cache in 'cache.sv'
+//
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// set associative cache with least recently used replacement
+//  'cache.sv': 1 way, write-back of dirty lines and write allocate
+//  write-through: stores are written to RAM and do not allocate on miss
+//  note: tags, valid and dirty flags only; data stays in emulated RAM
+class cache_model final {
+public:
+  enum class result { HIT, MISS, MISS_DIRTY_EVICTION };
+
+  enum class access_type { FETCH, LOAD, STORE };
+
+  enum class write_policy { WRITE_BACK, WRITE_THROUGH };
+
+private:
+  struct line final {
+    uint32_t tag{};
+    bool valid{};
+    bool dirty{};
+    uint64_t last_used{};
+  };
+
+  struct counters final {
+    uint64_t hits{};
+    uint64_t misses{};
+  };
+
+  std::vector<line> lines_; // 'ways_' consecutive lines per set
+  uint32_t line_index_bitwidth_{};
+  uint32_t line_offset_bitwidth_{};
+  uint32_t ways_{};
+  write_policy policy_{};
+  uint64_t accesses_{};
+
+  // statistics
+  counters fetch_;
+  counters data_;
+  uint64_t dirty_evictions_{};
+  // misses that evicted a valid line with a different tag, per line index
+  std::vector<uint64_t> conflict_misses_;
+
+public:
+  // 2 ^ 'line_index_bitwidth' sets of 'ways' lines of
+  // 2 ^ 'column_index_bitwidth' words
+  cache_model(uint32_t const line_index_bitwidth,
+              uint32_t const column_index_bitwidth, uint32_t const ways = 1,
+              write_policy const policy = write_policy::WRITE_BACK)
+      : lines_(size_t(ways) << line_index_bitwidth),
+        line_index_bitwidth_{line_index_bitwidth},
+        line_offset_bitwidth_{column_index_bitwidth + 2}, ways_{ways},
+        policy_{policy}, conflict_misses_(1u << line_index_bitwidth) {}
+
+  // accesses 'address' loading the line on miss unless it is a write-through
+  // store
+  auto access(uint32_t const address, access_type const type) -> result {
+    ++accesses_;
+    uint32_t const line_number = address >> line_offset_bitwidth_;
+    uint32_t const index = line_number & ((1u << line_index_bitwidth_) - 1);
+    uint32_t const tag = line_number >> line_index_bitwidth_;
+    line *const set = &lines_[size_t(index) * ways_];
+    counters &c = type == access_type::FETCH ? fetch_ : data_;
+    bool const is_store = type == access_type::STORE;
+
+    // find the line or the least recently used as victim
+    line *victim = set;
+    for (uint32_t i = 0; i < ways_; ++i) {
+      line &l = set[i];
+      if (l.valid && l.tag == tag) {
+        ++c.hits;
+        l.last_used = accesses_;
+        l.dirty |= is_store && policy_ == write_policy::WRITE_BACK;
+        return result::HIT;
+      }
+      if (!l.valid || (victim->valid && l.last_used < victim->last_used)) {
+        victim = &l;
+      }
+    }
+
+    ++c.misses;
+    if (is_store && policy_ == write_policy::WRITE_THROUGH) {
+      return result::MISS;
+    }
+    result r = result::MISS;
+    if (victim->valid) {
+      ++conflict_misses_[index];
+      if (victim->dirty) {
+        r = result::MISS_DIRTY_EVICTION;
+        ++dirty_evictions_;
+      }
+    }
+    *victim = {.tag = tag,
+               .valid = true,
+               .dirty = is_store,
+               .last_used = accesses_};
+    return r;
+  }
+
+  auto line_size_bytes() const -> uint32_t {
+    return 1u << line_offset_bitwidth_;
+  }
+
+  auto size_bytes() const -> uint32_t {
+    return uint32_t(lines_.size()) * line_size_bytes();
+  }
+
+  auto ways() const -> uint32_t { return ways_; }
+
+  auto policy() const -> write_policy { return policy_; }
+
+  auto fetch_miss_rate() const -> double { return miss_rate(fetch_); }
+
+  auto data_miss_rate() const -> double { return miss_rate(data_); }
+
+  auto dirty_evictions() const -> uint64_t { return dirty_evictions_; }
+
+  // prints geometry and statistics as JSON
+  auto print_json(FILE *const f) const -> void {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"line_index_bitwidth\": %u,\n", line_index_bitwidth_);
+    fprintf(f, "  \"line_size_bytes\": %u,\n", line_size_bytes());
+    fprintf(f, "  \"ways\": %u,\n", ways_);
+    fprintf(f, "  \"write_policy\": \"%s\",\n",
+            policy_ == write_policy::WRITE_BACK ? "write-back"
+                                                : "write-through");
+    fprintf(f, "  \"size_bytes\": %u,\n", size_bytes());
+    print_json_counters(f, "fetch", fetch_);
+    print_json_counters(f, "data", data_);
+    fprintf(f, "  \"dirty_evictions\": %llu,\n",
+            (unsigned long long)(dirty_evictions_));
+    fprintf(f, "  \"conflict_misses_per_line\": [");
+    for (size_t i = 0; i < conflict_misses_.size(); ++i) {
+      fprintf(f, "%s%s%llu", i ? "," : "", i % 16 ? " " : "\n    ",
+              (unsigned long long)(conflict_misses_[i]));
+    }
+    fprintf(f, "\n  ]\n");
+    fprintf(f, "}\n");
+  }
+
+private:
+  static auto miss_rate(counters const &c) -> double {
+    uint64_t const accesses = c.hits + c.misses;
+    return accesses ? double(c.misses) / double(accesses) : 0.0;
+  }
+
+  static auto print_json_counters(FILE *const f, char const *name,
+                                  counters const &c) -> void {
+    fprintf(f,
+            "  \"%s\": {\"accesses\": %llu, \"hits\": %llu, \"misses\": %llu, "
+            "\"miss_rate\": %.6f},\n",
+            name, (unsigned long long)(c.hits + c.misses),
+            (unsigned long long)(c.hits), (unsigned long long)(c.misses),
+            miss_rate(c));
+  }
+};
@@ -0,0 +1,164 @@
+//
+// evaluation of cache configurations in one run of the firmware
+//
+#pragma once
+
+#include "cache_model.hpp"
+#include "timing_model.hpp"
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <thread>
+#include <vector>
+
+// streams memory references in batches to timing models of cache
+// configurations that are distributed over worker threads
+//  note: references are batched in 2 buffers; one is filled while workers
+//        process the other
+class cache_sweep final {
+public:
+  struct configuration final {
+    uint32_t line_index_bitwidth{};
+    uint32_t column_index_bitwidth{};
+    uint32_t ways{};
+    cache_model::write_policy policy{};
+  };
+
+private:
+  struct reference final {
+    uint32_t address{};
+    cache_model::access_type type{};
+  };
+
+  static size_t constexpr BATCH_SIZE = 64 * 1024;
+
+  std::vector<timing_model> models_;
+  std::vector<reference> batches_[2];
+  size_t counts_[2]{}; // number of references in batch; 0 ends workers
+  size_t filling_{};   // index of batch being filled
+  std::barrier<> barrier_;
+  std::vector<std::thread> workers_;
+
+public:
+  cache_sweep(std::span<configuration const> const configurations,
+              uint32_t const io_addresses_start, uint32_t const frequency_hz,
+              uint32_t const worker_count)
+      : barrier_{std::ptrdiff_t(worker_count) + 1} {
+    for (configuration const &c : configurations) {
+      models_.emplace_back(cache_model{c.line_index_bitwidth,
+                                       c.column_index_bitwidth, c.ways,
+                                       c.policy},
+                           io_addresses_start, frequency_hz);
+    }
+    for (std::vector<reference> &b : batches_) {
+      b.resize(BATCH_SIZE);
+    }
+    for (uint32_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this, i, worker_count] { work(i, worker_count); });
+    }
+  }
+
+  cache_sweep(cache_sweep const &) = delete;
+  auto operator=(cache_sweep const &) -> cache_sweep & = delete;
+
+  ~cache_sweep() { finish(); }
+
+  auto execute(uint32_t const pc) -> void {
+    add(pc, cache_model::access_type::FETCH);
+  }
+
+  auto load(uint32_t const address) -> void {
+    add(address, cache_model::access_type::LOAD);
+  }
+
+  auto store(uint32_t const address) -> void {
+    add(address, cache_model::access_type::STORE);
+  }
+
+  // processes buffered references and ends the workers
+  auto finish() -> void {
+    if (workers_.empty()) {
+      return;
+    }
+    if (counts_[filling_]) {
+      publish();
+    }
+    publish(); // empty batch ends the workers
+    for (std::thread &t : workers_) {
+      t.join();
+    }
+    workers_.clear();
+  }
+
+  auto print_table(FILE *const f) const -> void {
+    fprintf(f, "%8s %6s %4s %-13s %10s %10s %10s %12s %7s %10s\n", "size B",
+            "line B", "ways", "write policy", "fetch miss", "data miss",
+            "dirty evic", "cycles", "CPI", "time s");
+    for (timing_model const &m : models_) {
+      cache_model const &c = m.cache();
+      fprintf(f,
+              "%8u %6u %4u %-13s %9.3f%% %9.3f%% %10llu %12llu %7.3f "
+              "%10.6f\n",
+              c.size_bytes(), c.line_size_bytes(), c.ways(),
+              c.policy() == cache_model::write_policy::WRITE_BACK
+                  ? "write-back"
+                  : "write-through",
+              c.fetch_miss_rate() * 100, c.data_miss_rate() * 100,
+              (unsigned long long)(c.dirty_evictions()),
+              (unsigned long long)(m.cycles()),
+              m.instructions() ? double(m.cycles()) / double(m.instructions())
+                               : 0.0,
+              m.seconds());
+    }
+  }
+
+private:
+  auto add(uint32_t const address, cache_model::access_type const type)
+      -> void {
+    size_t &n = counts_[filling_];
+    batches_[filling_][n] = {.address = address, .type = type};
+    ++n;
+    if (n == BATCH_SIZE) {
+      publish();
+    }
+  }
+
+  // hands the filled batch to the workers when they are done with the other
+  auto publish() -> void {
+    barrier_.arrive_and_wait();
+    filling_ ^= 1;
+    counts_[filling_] = 0;
+  }
+
+  // processes every 'worker_count' model starting at 'first_model'
+  auto work(size_t const first_model, size_t const worker_count) -> void {
+    for (size_t batch = 0;; batch ^= 1) {
+      barrier_.arrive_and_wait();
+      size_t const n = counts_[batch];
+      if (!n) {
+        return;
+      }
+      reference const *const refs = batches_[batch].data();
+      for (size_t i = first_model; i < models_.size(); i += worker_count) {
+        timing_model &m = models_[i];
+        for (size_t j = 0; j < n; ++j) {
+          switch (refs[j].type) {
+          case cache_model::access_type::FETCH:
+            m.execute(refs[j].address);
+            break;
+          case cache_model::access_type::LOAD:
+            m.load(refs[j].address);
+            break;
+          case cache_model::access_type::STORE:
+            m.store(refs[j].address);
+            break;
+          default:
+            break;
+          }
+        }
+      }
+    }
+  }
+};
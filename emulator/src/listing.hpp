@@ -0,0 +1,123 @@
+//
+// symbols and source lines of firmware from listing
+//
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// symbols and source lines of instructions parsed from a listing made by
+// 'objdump --source-comment -S' such as 'os/os.lst'
+//  function: "00001580 <uart_send_cstr(char const*)>:"
+//    source: "#     while (*str) {"
+//     instr: "    1584:\t00054783          \tlbu\ta5,0(a0)"
+class listing final {
+  struct symbol final {
+    uint32_t address{};
+    std::string name;
+  };
+
+  std::vector<symbol> symbols_; // sorted by address
+  std::vector<std::string> lines_;
+  std::unordered_map<uint32_t, uint32_t> line_of_address_;
+
+public:
+  static uint32_t constexpr NO_LINE = 0xffff'ffff;
+  static uint32_t constexpr NO_ADDRESS = 0xffff'ffff;
+
+  auto load(char const *file_name) -> bool {
+    FILE *const f = fopen(file_name, "r");
+    if (!f) {
+      return false;
+    }
+    std::unordered_map<std::string, uint32_t> line_ids;
+    uint32_t line = NO_LINE;
+    char *buf = nullptr;
+    size_t buf_size = 0;
+    ssize_t n = 0;
+    while ((n = getline(&buf, &buf_size, f)) != -1) {
+      std::string_view s{buf, size_t(n)};
+      if (s.ends_with('\n')) {
+        s.remove_suffix(1);
+      }
+      if (s.starts_with("# ")) {
+        s.remove_prefix(2);
+        size_t const first = s.find_first_not_of(" \t");
+        if (first == std::string_view::npos) {
+          continue; // keep the last non-empty line
+        }
+        s.remove_prefix(first);
+        auto const [it, inserted] =
+            line_ids.try_emplace(std::string{s}, uint32_t(lines_.size()));
+        if (inserted) {
+          lines_.emplace_back(s);
+        }
+        line = it->second;
+        continue;
+      }
+      char *end = nullptr;
+      uint32_t const address = uint32_t(strtoul(buf, &end, 16));
+      if (end == buf) {
+        continue;
+      }
+      std::string_view const rest{end};
+      if (rest.starts_with(" <") && rest.find(">:") != std::string_view::npos) {
+        symbols_.push_back(
+            {.address = address,
+             .name = std::string{rest.substr(2, rest.rfind(">:") - 2)}});
+        line = NO_LINE;
+      } else if (rest.starts_with(":\t") && line != NO_LINE) {
+        line_of_address_[address] = line;
+      }
+    }
+    free(buf);
+    fclose(f);
+    std::ranges::sort(symbols_, {}, &symbol::address);
+    return true;
+  }
+
+  // name of function containing 'address' or nullptr
+  auto symbol_at(uint32_t const address) const -> char const * {
+    size_t const i = symbol_index_at(address);
+    return i < symbols_.size() ? symbols_[i].name.c_str() : nullptr;
+  }
+
+  // index of function containing 'address' or number of symbols if none
+  auto symbol_index_at(uint32_t const address) const -> size_t {
+    auto const it = std::ranges::upper_bound(symbols_, address, {},
+                                             &symbol::address);
+    if (it == symbols_.begin()) {
+      return symbols_.size();
+    }
+    return size_t(it - symbols_.begin() - 1);
+  }
+
+  // address of function 'name' or 'NO_ADDRESS'
+  auto symbol_address(std::string_view const name) const -> uint32_t {
+    auto const it = std::ranges::find(symbols_, name, &symbol::name);
+    return it == symbols_.end() ? NO_ADDRESS : it->address;
+  }
+
+  auto symbol_count() const -> size_t { return symbols_.size(); }
+
+  auto symbol_name(size_t const index) const -> char const * {
+    return symbols_[index].name.c_str();
+  }
+
+  // id of source line of instruction at 'address' or 'NO_LINE'
+  //  note: lines with same text have same id
+  auto line_at(uint32_t const address) const -> uint32_t {
+    auto const it = line_of_address_.find(address);
+    return it == line_of_address_.end() ? NO_LINE : it->second;
+  }
+
+  auto line_text(uint32_t const id) const -> char const * {
+    return lines_[id].c_str();
+  }
+};
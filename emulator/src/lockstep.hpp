@@ -0,0 +1,126 @@
+//
+// comparison of execution with retirement trace of RTL simulation
+//
+#pragma once
+
+#include "trace.hpp"
+#include <cstdint>
+#include <cstdio>
+
+// compares records of retired instructions with the lines of a retirement
+// trace written by 'core.sv' built with 'RETIREMENT_TRACE' and stops at the
+// first divergence in pc, written register or store
+//  line: "<pc> <rd> <rd value> <store type> <store address> <store data>"
+//        with pc, values and address in hex; rd is 0 when no register is
+//        written and store type is 1 byte, 2 half word, 3 word or 0 if not a
+//        store
+//  note: loads are compared by the value written to the register thus input
+//        from 'uart_in' and SD card must be the same as in the simulation
+class lockstep_checker final {
+  struct expected final {
+    uint32_t pc{};
+    uint32_t rd{};
+    uint32_t rd_value{};
+    uint32_t store_type{};
+    uint32_t store_address{};
+    uint32_t store_data{};
+  };
+
+  FILE *file_{};
+  uint64_t compared_{};
+  bool done_{};
+  bool diverged_{};
+
+public:
+  lockstep_checker() = default;
+  lockstep_checker(lockstep_checker const &) = delete;
+  auto operator=(lockstep_checker const &) -> lockstep_checker & = delete;
+
+  ~lockstep_checker() {
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  auto open(char const *file_name) -> bool {
+    file_ = fopen(file_name, "r");
+    return file_ != nullptr;
+  }
+
+  // compares 'r' with next line of retirement trace
+  auto write(trace_record const &r) -> void {
+    if (done_) {
+      return;
+    }
+    expected e;
+    if (fscanf(file_, "%x %u %x %u %x %x", &e.pc, &e.rd, &e.rd_value,
+               &e.store_type, &e.store_address, &e.store_data) != 6) {
+      done_ = true;
+      return;
+    }
+    if (!matches(r, e)) {
+      fprintf(stderr, "lockstep: diverged at instruction %llu\n",
+              (unsigned long long)(compared_));
+      fprintf(stderr, "  emulator: pc 0x%08x", r.pc);
+      if (r.rd) {
+        fprintf(stderr, "  x%u = 0x%08x", r.rd, r.rd_value);
+      }
+      if (r.access == trace_record::memory_access::STORE) {
+        fprintf(stderr, "  store%u [0x%08x] 0x%08x", r.width, r.address,
+                r.value & mask(r.width));
+      }
+      fprintf(stderr, "\n       rtl: pc 0x%08x", e.pc);
+      if (e.rd) {
+        fprintf(stderr, "  x%u = 0x%08x", e.rd, e.rd_value);
+      }
+      if (e.store_type) {
+        uint32_t const width = store_width(e.store_type);
+        fprintf(stderr, "  store%u [0x%08x] 0x%08x", width, e.store_address,
+                e.store_data & mask(width));
+      }
+      fprintf(stderr, "\n");
+      done_ = true;
+      diverged_ = true;
+      return;
+    }
+    ++compared_;
+  }
+
+  // true when retirement trace ended or execution diverged
+  auto done() const -> bool { return done_; }
+
+  auto diverged() const -> bool { return diverged_; }
+
+  auto print_report(FILE *const f) const -> void {
+    if (!diverged_) {
+      fprintf(f, "lockstep: %llu instructions identical%s\n",
+              (unsigned long long)(compared_),
+              done_ ? "" : " (retirement trace not ended)");
+    }
+  }
+
+private:
+  static auto store_width(uint32_t const store_type) -> uint32_t {
+    return store_type == 3 ? 4 : store_type;
+  }
+
+  static auto mask(uint32_t const width) -> uint32_t {
+    return width == 4 ? 0xffff'ffff : (1u << (width * 8)) - 1;
+  }
+
+  static auto matches(trace_record const &r, expected const &e) -> bool {
+    if (r.pc != e.pc || r.rd != e.rd || (r.rd && r.rd_value != e.rd_value)) {
+      return false;
+    }
+    bool const is_store = r.access == trace_record::memory_access::STORE;
+    if (is_store != (e.store_type != 0)) {
+      return false;
+    }
+    if (!is_store) {
+      return true;
+    }
+    uint32_t const width = store_width(e.store_type);
+    return r.width == width && r.address == e.store_address &&
+           (r.value & mask(width)) == (e.store_data & mask(width));
+  }
+};
@@ -1,104 +1,107 @@
+#include <algorithm>
 #include <array>
+#include <csignal>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fcntl.h>
-#include <fstream>
+#include <iterator>
+#include <optional>
+#include <poll.h>
+#include <set>
+#include <string>
+#include <string_view>
 #include <termios.h>
-#include <unistd.h>
+#include <thread>
+#ifdef RV32I_STATISTICS
+#include <utility>
+#endif
 #include <vector>
+#include <unistd.h>
 // #define RV32I_DEBUG
 #include "rv32i.hpp"
 //
+#include "cache_sweep.hpp"
 #include "main_config.hpp"
+#include "listing.hpp"
+#include "lockstep.hpp"
+#include "mapped_file.hpp"
+#include "profiler.hpp"
+#include "snapshot.hpp"
+#include "stack_tracer.hpp"
+#include "test_runner.hpp"
+#include "timing_model.hpp"
+#include "trace.hpp"
 
 // #define LOG_UART_IN_TO_STDERR
 
 using namespace std;
 
-// initialize RAM with -1 being the default value from flash
-static vector<uint8_t> ram(osqa::memory_end, 0xff);
+// RAM initialized from firmware with -1 being the default value from flash
+static mapped_file ram;
+
+// SD card image mapped from file
+static mapped_file sdcard;
 
-// initialize SD card 8 MB
-static vector<uint8_t> sdcard(8 * 1024 * 1024, 0);
+// SD card is at least 8 MB with bytes beyond the image being zero
+static size_t constexpr sdcard_min_size = 8 * 1024 * 1024;
 
 // sdcard sector buffer
 static array<uint8_t, 512> sector_buffer;
 static size_t sector_buffer_index;
 
+// cycles the SD card is busy reading or writing a sector when timing is
+// modeled; estimate of 'sdcard.sv' at 30 MHz: 4096 data bits at 2 cycles per
+// SPI clock plus command, response, token and CRC
+static uint64_t constexpr sdcard_busy_cycles = 10'000;
+
+// cycle of the timing model at which the SD card has completed the command
+static uint64_t sdcard_ready_cycle = 0;
+
+// SD card sectors written since start that are saved in snapshots
+static set<uint32_t> sdcard_written_sectors;
+
+// snapshot saved at instruction count or at first wait for input if 0
+static char const *snapshot_file = nullptr;
+static uint64_t snapshot_at = 0;
+
+// state of registers at start; from snapshot when restored
+static snapshot_header start_state;
+
 // preserved terminal settings
 static struct termios saved_termios;
 
-// bus callback
-static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
-                bool const is_store, uint32_t &data) -> rv32i::bus_status {
+// instructions between two waits for input considered a polling loop
+static uint64_t constexpr idle_loop_max_instructions = 1'000;
 
-  // check if address is not an IO address and outside the memory range
-  if (address < osqa::io_addresses_start &&
-      address + uint32_t(op_width) > ram.size()) {
-    return 1;
-  }
+// output written since firmware last waited for input
+static bool uart_out_since_input_wait = false;
 
-  if (is_store) {
-    switch (address) {
-    case osqa::sdcard_busy: {
-      // address does not support write
-      return 2;
-    }
-    case osqa::sdcard_status: {
-      // address does not support write
-      return 3;
-    }
-    case osqa::sdcard_next_byte: {
-      sector_buffer[sector_buffer_index] = uint8_t(data);
-      sector_buffer_index = (sector_buffer_index + 1) % sector_buffer.size();
-      break;
-    }
-    case osqa::sdcard_write_sector: {
-      auto const dst = sdcard.begin() + data * sector_buffer.size();
-      auto const bgn = sector_buffer.begin();
-      auto const end = sector_buffer.end();
-      if (dst + sector_buffer.size() > sdcard.end()) {
-        return 4;
-      }
-      copy(bgn, end, dst);
-      break;
-    }
-    case osqa::sdcard_read_sector: {
-      auto const bgn = sdcard.begin() + data * sector_buffer.size();
-      auto const end = bgn + sector_buffer.size();
-      if (end > sdcard.end()) {
-        return 5;
-      }
-      copy(bgn, end, sector_buffer.data());
-      break;
-    }
-    case osqa::uart_out: {
-      int const ch = data & 0xff;
-      if (ch == 0x7f) {
-        // convert from serial to terminal
-        printf("\b \b");
-      } else {
-        putchar(ch);
-      }
-      fflush(stdout);
-      break;
-    }
-    case osqa::uart_in: {
-      // address does not support write
-      return 6;
-    }
-    case osqa::led: {
-      // do nothing when writing to address LED
-      break;
-    }
-    default: {
-      for (uint32_t i = 0; i < uint32_t(op_width); ++i) {
-        ram[address + i] = uint8_t(data >> (i * 8));
-      }
-    }
+// flush output when firmware is idle waiting for input
+static bool flush_on_idle = true;
+
+// milliseconds to block while firmware is polling for input
+static int constexpr idle_wait_timeout_ms = 10;
+
+// size of output buffer that is flushed when full
+static size_t constexpr uart_out_buffer_size = 64 * 1024;
+
+// signal that requested exit or 0
+static volatile sig_atomic_t exit_signal = 0;
+
+// bus with the I/O of the FPGA
+//  note: accesses within RAM are done directly by 'rv32i::cpu'
+struct osqa_bus final {
+  auto load(uint32_t const address, rv32i::bus_op_width const op_width,
+            uint32_t &data) -> rv32i::bus_status {
+
+    // check if address is not an IO address and outside the memory range
+    if (address < osqa::io_addresses_start &&
+        address + uint32_t(op_width) > ram.size()) {
+      return 1;
     }
-  } else {
-    // read op
+
     switch (address) {
     case osqa::sdcard_status: {
       data = 6;
@@ -113,6 +116,13 @@ static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
       sector_buffer_index = (sector_buffer_index + 1) % sector_buffer.size();
       break;
     }
+    case osqa::sdcard_next_word: {
+      // little endian word containing index as 'sdcard.sv' does
+      memcpy(&data, &sector_buffer.at(sector_buffer_index & ~size_t(3)),
+             sizeof(data));
+      sector_buffer_index = (sector_buffer_index + 4) % sector_buffer.size();
+      break;
+    }
     case osqa::sdcard_read_sector: {
       // address does not support read
       return 7;
@@ -135,7 +145,7 @@ static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
       switch (ch) {
       case EOF:             // no data available
         data = 0xffff'ffff; // -1
-        break;
+        return rv32i::BUS_IO_WAIT;
       case '\n': // newline to carriage return
         data = '\r';
         break;
@@ -160,61 +170,524 @@ static auto bus(uint32_t const address, rv32i::bus_op_width const op_width,
       }
     }
     }
+
+    return 0;
+  }
+
+  auto store(uint32_t const address, rv32i::bus_op_width const op_width,
+             uint32_t const data) -> rv32i::bus_status {
+
+    // check if address is not an IO address and outside the memory range
+    if (address < osqa::io_addresses_start &&
+        address + uint32_t(op_width) > ram.size()) {
+      return 1;
+    }
+
+    switch (address) {
+    case osqa::sdcard_busy: {
+      // address does not support write
+      return 2;
+    }
+    case osqa::sdcard_status: {
+      // address does not support write
+      return 3;
+    }
+    case osqa::sdcard_next_byte: {
+      sector_buffer[sector_buffer_index] = uint8_t(data);
+      sector_buffer_index = (sector_buffer_index + 1) % sector_buffer.size();
+      break;
+    }
+    case osqa::sdcard_next_word: {
+      memcpy(&sector_buffer.at(sector_buffer_index & ~size_t(3)), &data,
+             sizeof(data));
+      sector_buffer_index = (sector_buffer_index + 4) % sector_buffer.size();
+      break;
+    }
+    case osqa::sdcard_write_sector: {
+      size_t const offset = data * sector_buffer.size();
+      if (offset + sector_buffer.size() > sdcard.size()) {
+        return 4;
+      }
+      copy(sector_buffer.begin(), sector_buffer.end(), sdcard.data() + offset);
+      sdcard_written_sectors.insert(data);
+      break;
+    }
+    case osqa::sdcard_read_sector: {
+      size_t const offset = data * sector_buffer.size();
+      if (offset + sector_buffer.size() > sdcard.size()) {
+        return 5;
+      }
+      uint8_t const *const bgn = sdcard.data() + offset;
+      copy(bgn, bgn + sector_buffer.size(), sector_buffer.data());
+      break;
+    }
+    case osqa::uart_out: {
+      uart_out_since_input_wait = true;
+      int const ch = data & 0xff;
+      if (ch == 0x7f) {
+        // convert from serial to terminal
+        printf("\b \b");
+      } else {
+        putchar(ch);
+      }
+      break;
+    }
+    case osqa::uart_in: {
+      // address does not support write
+      return 6;
+    }
+    case osqa::led: {
+      // do nothing when writing to address LED
+      break;
+    }
+    default: {
+      for (uint32_t i = 0; i < uint32_t(op_width); ++i) {
+        ram[address + i] = uint8_t(data >> (i * 8));
+      }
+    }
+    }
+
+    return 0;
+  }
+
+  auto fetch(uint32_t const address, uint32_t &data) -> rv32i::bus_status {
+    return load(address, rv32i::bus_op_width::WORD, data);
+  }
+};
+
+// bus that also drives the enabled analyses of execution
+struct osqa_observed_bus final {
+  osqa_bus bus;
+  timing_model *timing = nullptr;
+  cache_sweep *sweep = nullptr;
+  profiler *profile = nullptr;
+  stack_tracer *stack = nullptr;
+  execution_tracer<trace_writer> *trace = nullptr;
+  execution_tracer<lockstep_checker> *lockstep = nullptr;
+
+  auto load(uint32_t const address, rv32i::bus_op_width const op_width,
+            uint32_t &data) -> rv32i::bus_status {
+    // with timing the SD card is busy for the modeled time of a command
+    if (timing && address == osqa::sdcard_busy) {
+      data = timing->cycles() < sdcard_ready_cycle ? 1 : 0;
+      return 0;
+    }
+    return bus.load(address, op_width, data);
+  }
+
+  auto store(uint32_t const address, rv32i::bus_op_width const op_width,
+             uint32_t const data) -> rv32i::bus_status {
+    if (timing && (address == osqa::sdcard_read_sector ||
+                   address == osqa::sdcard_write_sector)) {
+      sdcard_ready_cycle = timing->cycles() + sdcard_busy_cycles;
+    }
+    return bus.store(address, op_width, data);
+  }
+
+  auto fetch(uint32_t const address, uint32_t &data) -> rv32i::bus_status {
+    return bus.fetch(address, data);
+  }
+
+  auto on_execute(rv32i::decoded_instruction const &d, int32_t const *regs)
+      -> void {
+    if (stack) {
+      stack->execute(d, regs);
+    }
+    if (trace) {
+      trace->execute(d, regs);
+    }
+    if (lockstep) {
+      lockstep->execute(d, regs);
+    }
+    if (profile) {
+      profile->execute(d.pc, timing ? timing->cycles() : 0);
+    }
+    if (timing) {
+      timing->execute(d.pc);
+    }
+    if (sweep) {
+      sweep->execute(d.pc);
+    }
+  }
+
+  auto on_load(uint32_t const address, rv32i::bus_op_width const op_width,
+               uint32_t const data) -> void {
+    if (trace) {
+      trace->load(address, op_width, data);
+    }
+    if (lockstep) {
+      lockstep->load(address, op_width, data);
+    }
+    if (timing) {
+      timing->load(address);
+    }
+    if (sweep) {
+      sweep->load(address);
+    }
+  }
+
+  auto on_store(uint32_t const address, rv32i::bus_op_width const op_width,
+                uint32_t const data) -> void {
+    if (trace) {
+      trace->store(address, op_width, data);
+    }
+    if (lockstep) {
+      lockstep->store(address, op_width, data);
+    }
+    if (timing) {
+      timing->store(address);
+    }
+    if (sweep) {
+      sweep->store(address);
+    }
   }
+};
+
+// cache configurations evaluated by '--cache-sweep'
+//  first is 'cache.sv' as configured; others vary one parameter at a time or
+//  keep the size with more ways
+static cache_sweep::configuration constexpr cache_sweep_configurations[]{
+    {osqa::cache_line_index_bitwidth, osqa::cache_column_index_bitwidth, 1,
+     cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth, osqa::cache_column_index_bitwidth, 1,
+     cache_model::write_policy::WRITE_THROUGH},
+    {5, osqa::cache_column_index_bitwidth, 1,
+     cache_model::write_policy::WRITE_BACK},
+    {6, osqa::cache_column_index_bitwidth, 1,
+     cache_model::write_policy::WRITE_BACK},
+    {8, osqa::cache_column_index_bitwidth, 1,
+     cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth + 1, osqa::cache_column_index_bitwidth - 1,
+     1, cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth - 1, osqa::cache_column_index_bitwidth + 1,
+     1, cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth - 1, osqa::cache_column_index_bitwidth, 2,
+     cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth - 2, osqa::cache_column_index_bitwidth, 4,
+     cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth, osqa::cache_column_index_bitwidth, 2,
+     cache_model::write_policy::WRITE_BACK},
+    {osqa::cache_line_index_bitwidth, osqa::cache_column_index_bitwidth, 4,
+     cache_model::write_policy::WRITE_BACK},
+};
 
-  return 0;
+// blocks until input is available or timeout
+static auto wait_for_input() -> void {
+  if (feof(stdin)) {
+    // input closed; sleep instead of returning immediately
+    poll(nullptr, 0, idle_wait_timeout_ms);
+    return;
+  }
+  struct pollfd fd{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+  poll(&fd, 1, idle_wait_timeout_ms);
 }
 
-static auto load_file(char const *file_name, char const *data_name,
-                      vector<uint8_t> &data) -> bool {
+#ifdef RV32I_STATISTICS
+// prints instruction mix, load and store widths and the most executed
+// branches to stderr
+static auto print_statistics(rv32i::statistics const &s) -> void {
+  // in the order of 'rv32i::operation'
+  static char const *const names[]{
+      "lui",  "auipc", "jal",   "jalr", "beq",  "bne",  "blt",    "bge",
+      "bltu", "bgeu",  "lb",    "lh",   "lw",   "lbu",  "lhu",    "sb",
+      "sh",   "sw",    "addi",  "slti", "sltiu", "xori", "ori",   "andi",
+      "slli", "srli",  "srai",  "add",  "sub",  "sll",  "slt",    "sltu",
+      "xor",  "srl",   "sra",   "or",   "and",  "illegal"};
+  static_assert(size(names) == uint32_t(rv32i::operation::ILLEGAL) + 1);
 
-  ifstream file{file_name, ios::binary | ios::ate};
-  if (!file) {
-    printf("%s: error opening file '%s'\n", data_name, file_name);
-    return false;
+  using enum rv32i::operation;
+  auto const sum = [&s](rv32i::operation const first,
+                        rv32i::operation const last) -> uint64_t {
+    uint64_t n = 0;
+    for (uint32_t i = uint32_t(first); i <= uint32_t(last); ++i) {
+      n += s.operations[i];
+    }
+    return n;
+  };
+  uint64_t const total = sum(LUI, ILLEGAL);
+  auto const print = [total](char const *name, uint64_t const n) {
+    fprintf(stderr, "  %-14s %14llu %6.2f%%\n", name, (unsigned long long)(n),
+            total ? double(n) * 100 / double(total) : 0.0);
+  };
+
+  fprintf(stderr, "instruction classes:\n");
+  print("upper imm", sum(LUI, AUIPC));
+  print("jump", sum(JAL, JALR));
+  print("branch", sum(BEQ, BGEU));
+  print("load", sum(LB, LHU));
+  print("store", sum(SB, SW));
+  print("alu imm", sum(ADDI, SRAI));
+  print("alu reg", sum(ADD, AND));
+  print("illegal", sum(ILLEGAL, ILLEGAL));
+  print("total", total);
+
+  fprintf(stderr, "instructions:\n");
+  for (uint32_t i = 0; i < size(names); ++i) {
+    if (s.operations[i]) {
+      print(names[i], s.operations[i]);
+    }
   }
 
-  streamsize const size = file.tellg();
-  if (size == -1) {
-    printf("%s: error determining size of file '%s'\n", data_name, file_name);
-    return false;
+  fprintf(stderr, "load and store widths:\n");
+  print("load byte", sum(LB, LB) + sum(LBU, LBU));
+  print("load half", sum(LH, LH) + sum(LHU, LHU));
+  print("load word", sum(LW, LW));
+  print("store byte", sum(SB, SB));
+  print("store half", sum(SH, SH));
+  print("store word", sum(SW, SW));
+
+  uint64_t taken = 0;
+  vector<pair<uint32_t, rv32i::statistics::branch>> branches;
+  for (auto const &[pc, b] : s.branches) {
+    taken += b.taken;
+    branches.emplace_back(pc, b);
+  }
+  uint64_t const executed = sum(BEQ, BGEU);
+  fprintf(stderr, "branches: %llu executed, %.2f%% taken\n",
+          (unsigned long long)(executed),
+          executed ? double(taken) * 100 / double(executed) : 0.0);
+  ranges::sort(branches, [](auto const &a, auto const &b) {
+    return a.second.taken + a.second.not_taken >
+           b.second.taken + b.second.not_taken;
+  });
+  branches.resize(min(branches.size(), size_t(20)));
+  fprintf(stderr, "  %10s %14s %8s\n", "pc", "executed", "taken");
+  for (auto const &[pc, b] : branches) {
+    uint64_t const n = b.taken + b.not_taken;
+    fprintf(stderr, "  0x%08x %14llu %7.2f%%\n", pc, (unsigned long long)(n),
+            double(b.taken) * 100 / double(n));
   }
+}
+#endif
 
-  if (size > streamsize(data.size())) {
-    printf("%s: size of file (%zu B) exceeds size of data container (%zu B)\n",
-           data_name, size, data.size());
-    return false;
+// registers from 'start_state'
+template <typename cpu_type>
+static auto restore_registers(cpu_type &cpu) -> void {
+  for (uint32_t i = 1; i < 32; ++i) {
+    cpu.set_reg(i, start_state.regs[i]);
   }
+}
 
-  file.seekg(0, ios::beg);
-  if (file.fail()) {
-    printf("%s: error seeking to beginning of file '%s'\n", data_name,
-           file_name);
-    return false;
+// writes snapshot of state to 'snapshot_file'
+template <typename cpu_type>
+static auto save_snapshot(cpu_type const &cpu) -> void {
+  fflush(stdout);
+  snapshot_header h;
+  h.pc = cpu.pc();
+  for (uint32_t i = 0; i < 32; ++i) {
+    h.regs[i] = cpu.reg(i);
   }
+  h.sector_buffer_index = uint32_t(sector_buffer_index);
+  copy(sector_buffer.begin(), sector_buffer.end(), h.sector_buffer);
+  if (write_snapshot(snapshot_file, h, ram, sdcard.data(),
+                     sdcard_written_sectors)) {
+    fprintf(stderr, "Snapshot: saved '%s' at pc 0x%08x\n", snapshot_file,
+            h.pc);
+  }
+}
 
-  if (!file.read(reinterpret_cast<char *>(data.data()), size)) {
-    printf("%s: error reading file '%s'\n", data_name, file_name);
+// true when firmware is idle polling 'uart_in' without input
+//  note: firmware that polls input between characters of output is not idle
+static auto is_idle(rv32i::run_result const &r) -> bool {
+  if (r.reason != rv32i::stop_reason::IO_WAIT) {
     return false;
   }
+  bool const output = uart_out_since_input_wait;
+  uart_out_since_input_wait = false;
+  return !output && r.executed <= idle_loop_max_instructions;
+}
 
-  file.close();
+// runs firmware in batches of at most 'batch' instructions until error, exit
+// signal or 'stopped()' between batches and returns exit code
+template <typename cpu_type, typename stopped_type>
+static auto run(cpu_type &cpu, uint64_t const batch,
+                stopped_type const &stopped) -> int {
+  int exit_code = 0;
+  uint64_t executed = 0;
+  uint64_t since_io_wait = 0;
+  bool snapshot_pending = snapshot_file != nullptr;
+  while (!exit_signal && !exit_code && !stopped()) {
+    uint64_t budget = batch;
+    if (snapshot_pending && snapshot_at) {
+      budget = min(budget, snapshot_at - executed);
+    }
+    rv32i::run_result r = cpu.run(budget);
+    executed += r.executed;
+    // idle is decided by the instructions since the previous wait for I/O
+    // regardless of batch size
+    since_io_wait += r.executed;
+    r.executed = since_io_wait;
+    if (r.reason == rv32i::stop_reason::IO_WAIT) {
+      since_io_wait = 0;
+    }
+    if (r.reason == rv32i::stop_reason::ERROR) {
+      printf("CPU error: %d\n", r.error);
+      exit_code = int32_t(r.error);
+      continue;
+    }
+    bool const idle = is_idle(r);
+    if (snapshot_pending && (snapshot_at ? executed >= snapshot_at : idle)) {
+      save_snapshot(cpu);
+      snapshot_pending = false;
+    }
+    if (idle) {
+      if (flush_on_idle) {
+        fflush(stdout);
+      }
+      wait_for_input();
+    }
+  }
+#ifdef RV32I_STATISTICS
+  print_statistics(cpu.execution_statistics());
+#endif
+  if (exit_code) {
+    return exit_code;
+  }
+  return exit_signal ? 128 + exit_signal : 0;
+}
 
-  return true;
+static auto print_usage(char const *program) -> void {
+  printf("Usage: %s [options] <firmware.bin> <sdcard.bin>\n", program);
+  printf("  --throughput         flush output when buffer is full instead of\n"
+         "                       at newline and when firmware waits for input\n"
+         "  --sdcard-write-back  write SD card sectors to the image file\n"
+         "                       that is extended to 8 MB if smaller\n"
+         "  --timing             estimate cycles and time on the FPGA and\n"
+         "                       print to stderr at exit\n"
+         "  --cache-stats <file> write cache hits, misses and evictions as\n"
+         "                       JSON to file at exit\n"
+         "  --cache-sweep        evaluate cache configurations in one run and\n"
+         "                       print table to stderr at exit\n"
+         "  --profile            count instructions, with --timing cycles,\n"
+         "                       per function and source line of listing\n"
+         "                       and print top to stderr at exit\n"
+         "  --stack              record peak stack usage and deepest calls\n"
+         "                       and print to stderr at exit\n"
+         "  --trace <file>       write binary trace of executed instructions\n"
+         "                       (see 'osqa-trace')\n"
+         "  --lockstep <file>    compare execution with retirement trace of\n"
+         "                       RTL simulation and stop at first divergence\n"
+         "  --snapshot <file>    save machine state when firmware first waits\n"
+         "                       for input or see --snapshot-at\n"
+         "  --snapshot-at <n>    save snapshot after 'n' instructions\n"
+         "  --restore <file>     start from snapshot instead of firmware\n"
+         "  --test <file.in>     boot once and run test input in a forked\n"
+         "                       child comparing output with 'file.diff';\n"
+         "                       repeatable, children run in parallel\n"
+         "  --listing <file>     listing of firmware by 'objdump -S'\n"
+         "                       (default: firmware file with '.lst')\n"
+         "  --cache-line-index-bitwidth <n>\n"
+         "                       model cache with 2^n lines instead of "
+         "2^%u\n",
+         osqa::cache_line_index_bitwidth);
 }
 
 auto main(int argc, char **argv) -> int {
-  if (argc != 3) {
-    printf("Usage: %s <firmware.bin> <sdcard.bin>\n", argv[0]);
+  bool throughput = false;
+  bool sdcard_write_back = false;
+  bool timing = false;
+  char const *cache_stats_file = nullptr;
+  bool cache_sweep_enabled = false;
+  bool profile = false;
+  bool stack = false;
+  char const *trace_file = nullptr;
+  char const *lockstep_file = nullptr;
+  char const *restore_file = nullptr;
+  char const *listing_file = nullptr;
+  vector<char const *> tests;
+  uint32_t cache_line_index_bitwidth = osqa::cache_line_index_bitwidth;
+  char const *firmware_file = nullptr;
+  char const *sdcard_file = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    string_view const arg = argv[i];
+    if (arg == "--throughput") {
+      throughput = true;
+    } else if (arg == "--sdcard-write-back") {
+      sdcard_write_back = true;
+    } else if (arg == "--timing") {
+      timing = true;
+    } else if (arg == "--cache-stats" && i + 1 < argc) {
+      cache_stats_file = argv[++i];
+    } else if (arg == "--cache-sweep") {
+      cache_sweep_enabled = true;
+    } else if (arg == "--profile") {
+      profile = true;
+    } else if (arg == "--stack") {
+      stack = true;
+    } else if (arg == "--trace" && i + 1 < argc) {
+      trace_file = argv[++i];
+    } else if (arg == "--lockstep" && i + 1 < argc) {
+      lockstep_file = argv[++i];
+    } else if (arg == "--snapshot" && i + 1 < argc) {
+      snapshot_file = argv[++i];
+    } else if (arg == "--snapshot-at" && i + 1 < argc) {
+      snapshot_at = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--restore" && i + 1 < argc) {
+      restore_file = argv[++i];
+    } else if (arg == "--test" && i + 1 < argc) {
+      tests.push_back(argv[++i]);
+    } else if (arg == "--listing" && i + 1 < argc) {
+      listing_file = argv[++i];
+    } else if (arg == "--cache-line-index-bitwidth" && i + 1 < argc) {
+      cache_line_index_bitwidth = uint32_t(strtoul(argv[++i], nullptr, 10));
+      if (cache_line_index_bitwidth < 1 || cache_line_index_bitwidth > 24) {
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if (arg.starts_with("--") || sdcard_file) {
+      print_usage(argv[0]);
+      return 1;
+    } else if (!firmware_file) {
+      firmware_file = argv[i];
+    } else {
+      sdcard_file = argv[i];
+    }
+  }
+  if (!sdcard_file || (!tests.empty() && sdcard_write_back)) {
+    print_usage(argv[0]);
     return 1;
   }
 
-  if (!load_file(argv[1], "Firmware", ram)) {
+  if (!sdcard.map(sdcard_file, "SD card", sdcard_min_size,
+                  sdcard_write_back)) {
+    return 3;
+  }
+
+  if (restore_file) {
+    // RAM pages mapped copy-on-write from snapshot with the other pages
+    // filled as at start and written SD card sectors copied to the image
+    vector<uint8_t> ram_pages;
+    if (!read_snapshot(restore_file, start_state, ram_pages, sdcard.data(),
+                       sdcard.size(), sdcard_written_sectors)) {
+      return 2;
+    }
+    if (start_state.ram_size != osqa::memory_end) {
+      printf("Snapshot: RAM size %llu B differs from %u B\n",
+             (unsigned long long)(start_state.ram_size), osqa::memory_end);
+      return 2;
+    }
+    if (!ram.map_filled_pages(restore_file, "Snapshot", start_state.ram_offset,
+                              start_state.ram_size, 0xff, move(ram_pages))) {
+      return 2;
+    }
+    sector_buffer_index = start_state.sector_buffer_index;
+    copy(begin(start_state.sector_buffer), end(start_state.sector_buffer),
+         sector_buffer.begin());
+  } else if (!ram.map_filled(firmware_file, "Firmware", osqa::memory_end,
+                             0xff)) {
     return 2;
   }
 
-  if (!load_file(argv[2], "SD card", sdcard)) {
-    return 3;
+  // interactive output is flushed at newline and when input is read
+  setvbuf(stdout, nullptr, throughput ? _IOFBF : _IOLBF,
+          uart_out_buffer_size);
+
+  // tests run in forked children with input and output redirected
+  if (!tests.empty()) {
+    rv32i::cpu cpu{osqa_bus{}, ram.data(), uint32_t(ram.size()),
+                   start_state.pc};
+    restore_registers(cpu);
+    return test_runner{is_idle}.run(cpu, tests);
   }
 
   // configure terminal to not echo and enable non-blocking getchar()
@@ -233,14 +706,160 @@ auto main(int argc, char **argv) -> int {
     fcntl(STDIN_FILENO, F_SETFL, flags & ~O_NONBLOCK);
   });
 
-  rv32i::cpu cpu{bus};
+  // exit through 'main' to flush output and restore terminal
+  signal(SIGINT, [](int const sig) { exit_signal = sig; });
+  signal(SIGTERM, [](int const sig) { exit_signal = sig; });
+
+  flush_on_idle = !throughput;
+  osqa_bus const bus{};
+
+  if (!timing && !cache_stats_file && !cache_sweep_enabled && !profile &&
+      !stack && !trace_file && !lockstep_file) {
+    rv32i::cpu cpu{bus, ram.data(), uint32_t(ram.size()), start_state.pc};
+    restore_registers(cpu);
+    return run(cpu, 1'000'000, [] { return false; });
+  }
+
+  // analyses observe execution with an instantiation of the cpu that is
+  // used only when enabled
+  //  note: cache statistics are collected by the cache of the timing model
+  optional<timing_model> timing_analysis;
+  if (timing || cache_stats_file) {
+    timing_analysis.emplace(
+        cache_model{cache_line_index_bitwidth,
+                    osqa::cache_column_index_bitwidth},
+        osqa::io_addresses_start, osqa::cpu_frequency_hz);
+  }
+
+  optional<cache_sweep> sweep_analysis;
+  if (cache_sweep_enabled) {
+    uint32_t const workers =
+        clamp(thread::hardware_concurrency(), 1u,
+              uint32_t(size(cache_sweep_configurations)));
+    sweep_analysis.emplace(cache_sweep_configurations,
+                           osqa::io_addresses_start, osqa::cpu_frequency_hz,
+                           workers);
+  }
+
+  optional<profiler> profile_analysis;
+  if (profile) {
+    profile_analysis.emplace(osqa::memory_end);
+  }
+
+  optional<stack_tracer> stack_analysis;
+  if (stack) {
+    stack_analysis.emplace(osqa::memory_end);
+  }
+
+  trace_writer trace_output;
+  optional<execution_tracer<trace_writer>> trace_analysis;
+  if (trace_file) {
+    if (!trace_output.open(trace_file)) {
+      printf("Trace: error opening file '%s'\n", trace_file);
+      return 5;
+    }
+    trace_analysis.emplace(trace_output);
+  }
+
+  lockstep_checker lockstep_input;
+  optional<execution_tracer<lockstep_checker>> lockstep_analysis;
+  if (lockstep_file) {
+    if (!lockstep_input.open(lockstep_file)) {
+      printf("Lockstep: error opening file '%s'\n", lockstep_file);
+      return 6;
+    }
+    lockstep_analysis.emplace(lockstep_input);
+  }
+
+  rv32i::cpu cpu{
+      osqa_observed_bus{
+          .bus = bus,
+          .timing = timing_analysis ? &*timing_analysis : nullptr,
+          .sweep = sweep_analysis ? &*sweep_analysis : nullptr,
+          .profile = profile_analysis ? &*profile_analysis : nullptr,
+          .stack = stack_analysis ? &*stack_analysis : nullptr,
+          .trace = trace_analysis ? &*trace_analysis : nullptr,
+          .lockstep = lockstep_analysis ? &*lockstep_analysis : nullptr,
+      },
+      ram.data(), uint32_t(ram.size()), start_state.pc};
+  restore_registers(cpu);
+
+  // registers after the last executed instruction
+  auto const registers = [&cpu] {
+    array<int32_t, 32> regs{};
+    for (uint32_t i = 0; i < 32; ++i) {
+      regs[i] = cpu.reg(i);
+    }
+    return regs;
+  };
+
+  // with lockstep an instruction is compared as soon as it retired so that
+  // execution stops at the first divergence
+  int exit_code = run(cpu, lockstep_analysis ? 1 : 1'000'000, [&] {
+    if (!lockstep_analysis) {
+      return false;
+    }
+    lockstep_analysis->complete(registers().data());
+    return lockstep_input.done();
+  });
+
+  if (timing) {
+    timing_analysis->print_report(stderr);
+  }
+
+  array<int32_t, 32> const regs = registers();
+
+  if (trace_analysis) {
+    trace_analysis->complete(regs.data());
+    trace_output.close();
+  }
+
+  if (lockstep_analysis) {
+    lockstep_analysis->complete(regs.data());
+    lockstep_input.print_report(stderr);
+    if (lockstep_input.diverged()) {
+      exit_code = 1;
+    }
+  }
+
+  // symbols and source lines for reports
+  listing lst;
+  if (profile || stack) {
+    string const default_listing_file =
+        string{firmware_file}.substr(0, string{firmware_file}.rfind('.')) +
+        ".lst";
+    if (!listing_file) {
+      listing_file = default_listing_file.c_str();
+    }
+    if (!lst.load(listing_file)) {
+      fprintf(stderr, "Listing: error opening file '%s'\n", listing_file);
+    }
+  }
+
+  if (profile_analysis) {
+    profile_analysis->finish(timing_analysis ? timing_analysis->cycles() : 0);
+    profile_analysis->print_report(stderr, lst, 20);
+  }
+
+  if (stack_analysis) {
+    stack_analysis->print_report(stderr, lst);
+  }
+
+  if (sweep_analysis) {
+    sweep_analysis->finish();
+    sweep_analysis->print_table(stderr);
+  }
 
-  while (true) {
-    if (rv32i::cpu::status const s = cpu.tick()) {
-      printf("CPU error: %d\n", s);
-      return int32_t(s);
+  if (cache_stats_file) {
+    FILE *const f = fopen(cache_stats_file, "w");
+    if (!f) {
+      fprintf(stderr, "Cache statistics: error opening file '%s'\n",
+              cache_stats_file);
+      return 4;
     }
+    timing_analysis->cache().print_json(f);
+    fclose(f);
   }
 
-  return 0;
+  return exit_code;
 }
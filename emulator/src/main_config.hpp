@@ -13,7 +13,15 @@ std::uint32_t constexpr sdcard_read_sector = 0xffff'ffec;
 std::uint32_t constexpr sdcard_next_byte = 0xffff'ffe8;
 std::uint32_t constexpr sdcard_status = 0xffff'ffe4;
 std::uint32_t constexpr sdcard_write_sector = 0xffff'ffe0;
-std::uint32_t constexpr io_addresses_start = 0xffff'ffe0;
+std::uint32_t constexpr sdcard_next_word = 0xffff'ffdc;
+std::uint32_t constexpr io_addresses_start = 0xffff'ffdc;
 std::uint32_t constexpr memory_end = 0x800000;
 
+// cache
+std::uint32_t constexpr cache_column_index_bitwidth = 3;
+std::uint32_t constexpr cache_line_index_bitwidth = 7;
+
+// CPU
+std::uint32_t constexpr cpu_frequency_hz = 30000000;
+
 } // namespace osqa
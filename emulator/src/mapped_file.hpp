@@ -0,0 +1,361 @@
+//
+// file mapped into memory
+//
+// note: shared by emulator, emulator qa and console application
+//
+#pragma once
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// file mapped into memory
+//  note: pages are read from file when first accessed
+//  note: first 'map_filled' installs a process-wide 'SIGSEGV' handler that
+//        fills pages of filled mappings and forwards other faults to the
+//        handler that was installed before
+class mapped_file final {
+  uint8_t *data_{};
+  size_t size_{};
+  // one per page of a filled mapping; non-zero when page holds data
+  std::vector<uint8_t> pages_;
+
+  // pages filled with 'fill' when first accessed and then marked in 'pages'
+  //  note: zero initialized as static
+  struct fill_region final {
+    uint8_t *begin;
+    uint8_t *end;
+    uint8_t *pages;
+    uint8_t fill;
+  };
+
+  static size_t constexpr FILL_REGIONS_MAX = 4;
+  static inline fill_region fill_regions_[FILL_REGIONS_MAX]{};
+  static inline size_t page_size_{};
+  static inline struct sigaction previous_action_{};
+
+public:
+  mapped_file() = default;
+  mapped_file(mapped_file const &) = delete;
+  auto operator=(mapped_file const &) -> mapped_file & = delete;
+
+  ~mapped_file() {
+    if (!data_) {
+      return;
+    }
+    for (fill_region &r : fill_regions_) {
+      if (r.begin >= data_ && r.begin < data_ + size_) {
+        r = {};
+      }
+    }
+    munmap(data_, size_);
+  }
+
+  // maps 'file_name' with at least 'min_size' bytes
+  //  private mapping is copy-on-write with bytes beyond the file being zero
+  //  shared mapping writes back to the file which is extended to 'min_size'
+  auto map(char const *file_name, char const *data_name,
+           size_t const min_size, bool const write_back) -> bool {
+
+    int const fd = open(file_name, write_back ? O_RDWR : O_RDONLY);
+    if (fd == -1) {
+      printf("%s: error opening file '%s'\n", data_name, file_name);
+      return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+      printf("%s: error determining size of file '%s'\n", data_name,
+             file_name);
+      close(fd);
+      return false;
+    }
+
+    size_t const file_size = size_t(st.st_size);
+    size_t const size = file_size > min_size ? file_size : min_size;
+
+    if (write_back) {
+      if (file_size < size && ftruncate(fd, off_t(size)) == -1) {
+        printf("%s: error extending file '%s' to %zu B\n", data_name,
+               file_name, size);
+        close(fd);
+        return false;
+      }
+      void *const p =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if (p == MAP_FAILED) {
+        printf("%s: error mapping file '%s'\n", data_name, file_name);
+        return false;
+      }
+      data_ = static_cast<uint8_t *>(p);
+      size_ = size;
+      return true;
+    }
+
+    // zero pages beyond the file are not allocated until written
+    void *const p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+      printf("%s: error allocating %zu B\n", data_name, size);
+      close(fd);
+      return false;
+    }
+
+    // map file over the beginning
+    //  note: remainder of last page beyond end of file is zero
+    if (file_size &&
+        mmap(p, file_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd, 0) == MAP_FAILED) {
+      printf("%s: error mapping file '%s'\n", data_name, file_name);
+      munmap(p, size);
+      close(fd);
+      return false;
+    }
+    close(fd);
+
+    data_ = static_cast<uint8_t *>(p);
+    size_ = size;
+    return true;
+  }
+
+  // maps 'file_name' private into 'size' bytes with bytes beyond the file
+  // being 'fill'
+  //  note: pages beyond the file are filled when first accessed
+  auto map_filled(char const *file_name, char const *data_name,
+                  size_t const size, uint8_t const fill) -> bool {
+
+    int const fd = open(file_name, O_RDONLY);
+    if (fd == -1) {
+      printf("%s: error opening file '%s'\n", data_name, file_name);
+      return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+      printf("%s: error determining size of file '%s'\n", data_name,
+             file_name);
+      close(fd);
+      return false;
+    }
+
+    size_t const file_size = size_t(st.st_size);
+    if (file_size > size) {
+      printf("%s: size of file (%zu B) exceeds size of data container (%zu "
+             "B)\n",
+             data_name, file_size, size);
+      close(fd);
+      return false;
+    }
+
+    fill_region *const region = free_fill_region();
+    if (!region) {
+      printf("%s: more than %zu filled mappings\n", data_name,
+             FILL_REGIONS_MAX);
+      close(fd);
+      return false;
+    }
+
+    // inaccessible until first access fills the page
+    void *const p = mmap(nullptr, size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+      printf("%s: error allocating %zu B\n", data_name, size);
+      close(fd);
+      return false;
+    }
+    uint8_t *const bytes = static_cast<uint8_t *>(p);
+
+    // map whole pages of file
+    size_t const file_pages_size = file_size / page_size_ * page_size_;
+    if (file_pages_size &&
+        mmap(p, file_pages_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd, 0) == MAP_FAILED) {
+      printf("%s: error mapping file '%s'\n", data_name, file_name);
+      munmap(p, size);
+      close(fd);
+      return false;
+    }
+
+    // read the remainder of the file into a filled page
+    size_t const tail_size = file_size - file_pages_size;
+    uint8_t *const tail = bytes + file_pages_size;
+    if (tail_size) {
+      mprotect(tail, page_size_, PROT_READ | PROT_WRITE);
+      memset(tail, fill, page_size_);
+      size_t n = 0;
+      while (n < tail_size) {
+        ssize_t const r = pread(fd, tail + n, tail_size - n,
+                                off_t(file_pages_size + n));
+        if (r <= 0) {
+          printf("%s: error reading file '%s'\n", data_name, file_name);
+          munmap(p, size);
+          close(fd);
+          return false;
+        }
+        n += size_t(r);
+      }
+    }
+    close(fd);
+
+    // pages of the file hold data
+    pages_.assign((size + page_size_ - 1) / page_size_, 0);
+    memset(pages_.data(), 1, (file_size + page_size_ - 1) / page_size_);
+    *region = {.begin = bytes,
+               .end = bytes + size,
+               .pages = pages_.data(),
+               .fill = fill};
+    data_ = bytes;
+    size_ = size;
+    return true;
+  }
+
+  // maps 'size' bytes with the pages marked in 'pages' read private from
+  // consecutive pages of 'file_name' at 'offset' and the other pages being
+  // 'fill'
+  //  note: 'pages' has one entry per page of 'size'
+  //  note: pages are copied when first written and filled when first accessed
+  auto map_filled_pages(char const *file_name, char const *data_name,
+                        size_t const offset, size_t const size,
+                        uint8_t const fill, std::vector<uint8_t> pages)
+      -> bool {
+
+    int const fd = open(file_name, O_RDONLY);
+    if (fd == -1) {
+      printf("%s: error opening file '%s'\n", data_name, file_name);
+      return false;
+    }
+
+    fill_region *const region = free_fill_region();
+    if (!region) {
+      printf("%s: more than %zu filled mappings\n", data_name,
+             FILL_REGIONS_MAX);
+      close(fd);
+      return false;
+    }
+
+    size_t const page_count = (size + page_size_ - 1) / page_size_;
+    size_t present = 0;
+    for (uint8_t const page : pages) {
+      present += page ? 1 : 0;
+    }
+    struct stat st{};
+    if (pages.size() != page_count || fstat(fd, &st) == -1 ||
+        size_t(st.st_size) < offset + present * page_size_) {
+      printf("%s: file '%s' does not hold the %zu pages\n", data_name,
+             file_name, present);
+      close(fd);
+      return false;
+    }
+
+    // inaccessible until first access fills the page
+    void *const p = mmap(nullptr, size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+      printf("%s: error allocating %zu B\n", data_name, size);
+      close(fd);
+      return false;
+    }
+    uint8_t *const bytes = static_cast<uint8_t *>(p);
+
+    // map runs of marked pages
+    size_t file_offset = offset;
+    for (size_t i = 0; i < page_count;) {
+      if (!pages[i]) {
+        ++i;
+        continue;
+      }
+      size_t n = 1;
+      while (i + n < page_count && pages[i + n]) {
+        ++n;
+      }
+      if (mmap(bytes + i * page_size_, n * page_size_, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd,
+               off_t(file_offset)) == MAP_FAILED) {
+        printf("%s: error mapping file '%s'\n", data_name, file_name);
+        munmap(p, size);
+        close(fd);
+        return false;
+      }
+      file_offset += n * page_size_;
+      i += n;
+    }
+    close(fd);
+
+    pages_ = std::move(pages);
+    *region = {.begin = bytes,
+               .end = bytes + size,
+               .pages = pages_.data(),
+               .fill = fill};
+    data_ = bytes;
+    size_ = size;
+    return true;
+  }
+
+  auto operator[](size_t const i) const -> uint8_t & { return data_[i]; }
+
+  auto data() const -> uint8_t * { return data_; }
+  auto size() const -> size_t { return size_; }
+
+  // true when page holding byte 'i' holds data read from file or filled
+  //  note: all pages of mappings that are not filled hold data
+  auto is_page_present(size_t const i) const -> bool {
+    return pages_.empty() || pages_[i / page_size_];
+  }
+
+private:
+  // installs the 'SIGSEGV' handler at first call and returns an unused fill
+  // region or nullptr
+  static auto free_fill_region() -> fill_region * {
+    if (!page_size_) {
+      page_size_ = size_t(sysconf(_SC_PAGESIZE));
+      struct sigaction sa{};
+      sa.sa_sigaction = on_segmentation_fault;
+      sa.sa_flags = SA_SIGINFO;
+      sigemptyset(&sa.sa_mask);
+      sigaction(SIGSEGV, &sa, &previous_action_);
+    }
+    for (fill_region &r : fill_regions_) {
+      if (!r.begin) {
+        return &r;
+      }
+    }
+    return nullptr;
+  }
+
+  // fills the accessed page of a fill region or forwards to the previous
+  // handler
+  //  note: a previous default or ignore action is restored and applies when
+  //        the access is retried
+  static auto on_segmentation_fault(int const sig, siginfo_t *const info,
+                                    void *const context) -> void {
+    uint8_t *const address = static_cast<uint8_t *>(info->si_addr);
+    for (fill_region const &r : fill_regions_) {
+      if (address >= r.begin && address < r.end) {
+        size_t const page_index = size_t(address - r.begin) / page_size_;
+        uint8_t *const page = r.begin + page_index * page_size_;
+        mprotect(page, page_size_, PROT_READ | PROT_WRITE);
+        memset(page, r.fill, page_size_);
+        r.pages[page_index] = 1;
+        return;
+      }
+    }
+    if (previous_action_.sa_flags & SA_SIGINFO) {
+      previous_action_.sa_sigaction(sig, info, context);
+      return;
+    }
+    if (previous_action_.sa_handler == SIG_DFL ||
+        previous_action_.sa_handler == SIG_IGN) {
+      sigaction(sig, &previous_action_, nullptr);
+      return;
+    }
+    previous_action_.sa_handler(sig);
+  }
+};
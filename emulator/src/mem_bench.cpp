@@ -0,0 +1,196 @@
+//
+// measures the firmware 'memset', 'memcpy', 'memmove' and 'memcmp' by calling
+// them in the emulator with the timing model
+//
+#include "listing.hpp"
+#include "main_config.hpp"
+#include "mapped_file.hpp"
+#include "rv32i.hpp"
+#include "timing_model.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// RAM initialized from firmware with -1 being the default value from flash
+static mapped_file ram;
+
+// called function returns to an instruction that waits for input
+static uint32_t constexpr return_address = osqa::memory_end - 4;
+static uint32_t constexpr stack_pointer = osqa::memory_end - 16;
+// lw x0, -12(x0) (address of 'uart_in')
+static uint32_t constexpr wait_instruction = 0xff40'2003;
+
+// buffers used as arguments
+static uint32_t constexpr buffer_1 = osqa::memory_end / 2;
+static uint32_t constexpr buffer_2 = buffer_1 + 0x1'0000;
+
+struct bench_result final {
+  uint64_t instructions{};
+  uint64_t loads{};
+  uint64_t stores{};
+  uint64_t cycles{};
+  int32_t return_value{};
+  bool ok{};
+};
+
+// loads from I/O wait and RAM accesses are counted and modeled
+struct bench_bus final {
+  timing_model *timing = nullptr;
+  bench_result *result = nullptr;
+
+  auto load(uint32_t const, rv32i::bus_op_width const, uint32_t &data)
+      -> rv32i::bus_status {
+    data = 0xffff'ffff;
+    return rv32i::BUS_IO_WAIT;
+  }
+
+  auto store(uint32_t const, rv32i::bus_op_width const, uint32_t const)
+      -> rv32i::bus_status {
+    return 1;
+  }
+
+  auto fetch(uint32_t const, uint32_t &) -> rv32i::bus_status { return 1; }
+
+  auto on_execute(rv32i::decoded_instruction const &d, int32_t const *)
+      -> void {
+    if (d.pc != return_address) {
+      timing->execute(d.pc);
+    }
+  }
+
+  auto on_load(uint32_t const address, rv32i::bus_op_width const,
+               uint32_t const) -> void {
+    if (address < osqa::memory_end) {
+      timing->load(address);
+      ++result->loads;
+    }
+  }
+
+  auto on_store(uint32_t const address, rv32i::bus_op_width const,
+                uint32_t const) -> void {
+    timing->store(address);
+    ++result->stores;
+  }
+};
+
+// calls function at 'address' with arguments in a0..a2
+static auto call(uint32_t const address, uint32_t const a0, uint32_t const a1,
+                 uint32_t const a2) -> bench_result {
+  timing_model timing{cache_model{osqa::cache_line_index_bitwidth,
+                                  osqa::cache_column_index_bitwidth},
+                      osqa::io_addresses_start, osqa::cpu_frequency_hz};
+  bench_result result;
+  rv32i::cpu cpu{bench_bus{.timing = &timing, .result = &result}, ram.data(),
+                 uint32_t(ram.size()), address};
+  cpu.set_reg(1, int32_t(return_address));
+  cpu.set_reg(2, int32_t(stack_pointer));
+  cpu.set_reg(10, int32_t(a0));
+  cpu.set_reg(11, int32_t(a1));
+  cpu.set_reg(12, int32_t(a2));
+  rv32i::run_result const r = cpu.run(100'000'000);
+  result.instructions = timing.instructions();
+  result.cycles = timing.cycles();
+  result.return_value = cpu.reg(10);
+  // the waiting load retires
+  result.ok = r.reason == rv32i::stop_reason::IO_WAIT &&
+              cpu.pc() == return_address + 4;
+  return result;
+}
+
+static auto fill_pattern(uint32_t const address, uint32_t const size,
+                         uint32_t const seed) -> void {
+  for (uint32_t i = 0; i < size; ++i) {
+    ram[address + i] = uint8_t(i * 7 + seed);
+  }
+}
+
+static auto print_result(char const *function, uint32_t const size,
+                         uint32_t const dst_offset, uint32_t const src_offset,
+                         bench_result const &r, bool const correct) -> void {
+  printf("%-8s %6u %4u %4u %12llu %10llu %10llu %12llu%s\n", function, size,
+         dst_offset, src_offset, (unsigned long long)(r.instructions),
+         (unsigned long long)(r.loads), (unsigned long long)(r.stores),
+         (unsigned long long)(r.cycles),
+         r.ok && correct ? "" : "  FAILED");
+}
+
+auto main(int argc, char **argv) -> int {
+  if (argc < 2) {
+    printf("Usage: %s <firmware.bin> [listing]\n"
+           "  listing by 'objdump -S' (default: firmware file with '.lst')\n",
+           argv[0]);
+    return 1;
+  }
+  char const *firmware_file = argv[1];
+  string const listing_file =
+      argc > 2 ? string{argv[2]}
+               : string{firmware_file}.substr(
+                     0, string{firmware_file}.rfind('.')) +
+                     ".lst";
+  if (!ram.map_filled(firmware_file, "Firmware", osqa::memory_end, 0xff)) {
+    return 2;
+  }
+  listing lst;
+  if (!lst.load(listing_file.c_str())) {
+    printf("Listing: error opening file '%s'\n", listing_file.c_str());
+    return 2;
+  }
+  memcpy(&ram[return_address], &wait_instruction, sizeof(wait_instruction));
+
+  uint32_t const sizes[]{4, 15, 64, 512, 4096};
+  uint32_t const offsets[][2]{{0, 0}, {1, 1}, {1, 2}};
+  bool failed = false;
+
+  printf("function   size  dst  src instructions      loads     stores"
+         "       cycles\n");
+  for (char const *function : {"memset", "memcpy", "memmove", "memcmp"}) {
+    uint32_t const address = lst.symbol_address(function);
+    if (address == listing::NO_ADDRESS) {
+      printf("%-8s not in listing\n", function);
+      continue;
+    }
+    string_view const f{function};
+    for (uint32_t const size : sizes) {
+      for (auto const [dst_offset, src_offset] : offsets) {
+        if (f == "memset" && dst_offset != src_offset) {
+          continue;
+        }
+        uint32_t const dst = buffer_1 + dst_offset;
+        // 'memmove' copies within overlapping buffer
+        uint32_t const src =
+            f == "memmove" ? buffer_1 + size / 2 + src_offset
+                           : buffer_2 + src_offset;
+        fill_pattern(buffer_1, size + 8, 1);
+        fill_pattern(buffer_2, size + 8, 2);
+        string expected{reinterpret_cast<char const *>(&ram[src]), size};
+        bench_result r;
+        bool correct = true;
+        if (f == "memset") {
+          r = call(address, dst, 0xa5, size);
+          expected.assign(size, char(0xa5));
+        } else if (f == "memcmp") {
+          // equal up to the last byte
+          memcpy(&ram[dst], &ram[src], size);
+          ++ram[src + size - 1];
+          r = call(address, dst, src, size);
+          int const cmp = memcmp(&ram[dst], &ram[src], size);
+          correct = (r.return_value < 0) == (cmp < 0) &&
+                    (r.return_value > 0) == (cmp > 0);
+        } else {
+          r = call(address, dst, src, size);
+        }
+        if (f != "memcmp") {
+          correct = !memcmp(&ram[dst], expected.data(), size) &&
+                    uint32_t(r.return_value) == dst;
+        }
+        failed = failed || !r.ok || !correct;
+        print_result(function, size, dst_offset, src_offset, r, correct);
+      }
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+//
+// instructions and cycles per program counter
+//
+#pragma once
+
+#include "listing.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+// counts retired instructions and, given cycle counts, cycles per instruction
+// address and reports the top functions and source lines
+//  note: cycles between two executed instructions are attributed to the
+//        first one
+class profiler final {
+  struct counters final {
+    uint64_t instructions{};
+    uint64_t cycles{};
+  };
+
+  std::vector<counters> counters_; // index: pc / 4
+  uint32_t previous_pc_{};
+  uint64_t previous_cycle_{};
+  bool started_{};
+
+public:
+  // profiles instructions in addresses below 'memory_end'
+  explicit profiler(uint32_t const memory_end) : counters_(memory_end / 4) {}
+
+  // instruction at 'pc' is about to execute at 'cycle'
+  auto execute(uint32_t const pc, uint64_t const cycle) -> void {
+    if (started_) {
+      add_cycles(cycle);
+    }
+    started_ = true;
+    previous_pc_ = pc;
+    previous_cycle_ = cycle;
+    uint32_t const i = pc >> 2;
+    if (i < counters_.size()) {
+      ++counters_[i].instructions;
+    }
+  }
+
+  // attributes cycles of the last executed instruction
+  auto finish(uint64_t const cycle) -> void {
+    if (started_) {
+      add_cycles(cycle);
+      previous_cycle_ = cycle;
+    }
+  }
+
+  // prints the 'top' functions and source lines by cycles or by instructions
+  // if no cycles were counted
+  auto print_report(FILE *const f, listing const &lst,
+                    size_t const top) const -> void {
+    // aggregate by function and by function and source line
+    //  note: key of line is symbol index << 32 | line id
+    std::unordered_map<size_t, counters> functions;
+    std::unordered_map<uint64_t, counters> lines;
+    counters total;
+    for (size_t i = 0; i < counters_.size(); ++i) {
+      counters const &c = counters_[i];
+      if (!c.instructions) {
+        continue;
+      }
+      uint32_t const pc = uint32_t(i << 2);
+      size_t const symbol = lst.symbol_index_at(pc);
+      add(functions[symbol], c);
+      add(lines[uint64_t(symbol) << 32 | lst.line_at(pc)], c);
+      add(total, c);
+    }
+
+    bool const by_cycles = total.cycles != 0;
+    fprintf(f, "profile: %llu instructions, %llu cycles\n",
+            (unsigned long long)(total.instructions),
+            (unsigned long long)(total.cycles));
+
+    fprintf(f, "\n%14s %7s %14s %7s  %s\n", "instructions", "%", "cycles", "%",
+            "function");
+    for (auto const &[symbol, c] : sorted(functions, by_cycles, top)) {
+      print_counters(f, c, total);
+      fprintf(f, "  %s\n", symbol_name(lst, symbol));
+    }
+
+    fprintf(f, "\n%14s %7s %14s %7s  %s\n", "instructions", "%", "cycles", "%",
+            "function: source line");
+    for (auto const &[key, c] : sorted(lines, by_cycles, top)) {
+      size_t const symbol = key >> 32;
+      uint32_t const line = uint32_t(key);
+      print_counters(f, c, total);
+      fprintf(f, "  %s: %s\n", symbol_name(lst, symbol),
+              line == listing::NO_LINE ? "?" : lst.line_text(line));
+    }
+  }
+
+private:
+  auto add_cycles(uint64_t const cycle) -> void {
+    uint32_t const i = previous_pc_ >> 2;
+    if (i < counters_.size()) {
+      counters_[i].cycles += cycle - previous_cycle_;
+    }
+  }
+
+  static auto add(counters &to, counters const &c) -> void {
+    to.instructions += c.instructions;
+    to.cycles += c.cycles;
+  }
+
+  // 'top' entries of 'map' in descending order of cycles or instructions
+  template <typename key_type>
+  static auto sorted(std::unordered_map<key_type, counters> const &map,
+                     bool const by_cycles, size_t const top)
+      -> std::vector<std::pair<key_type, counters>> {
+    std::vector<std::pair<key_type, counters>> v{map.begin(), map.end()};
+    std::ranges::sort(v, [by_cycles](auto const &a, auto const &b) {
+      return by_cycles ? a.second.cycles > b.second.cycles
+                       : a.second.instructions > b.second.instructions;
+    });
+    v.resize(std::min(v.size(), top));
+    return v;
+  }
+
+  static auto symbol_name(listing const &lst, size_t const symbol)
+      -> char const * {
+    return symbol < lst.symbol_count() ? lst.symbol_name(symbol) : "?";
+  }
+
+  static auto print_counters(FILE *const f, counters const &c,
+                             counters const &total) -> void {
+    fprintf(f, "%14llu %6.2f%% %14llu %6.2f%%",
+            (unsigned long long)(c.instructions),
+            percent(c.instructions, total.instructions),
+            (unsigned long long)(c.cycles), percent(c.cycles, total.cycles));
+  }
+
+  static auto percent(uint64_t const n, uint64_t const total) -> double {
+    return total ? double(n) * 100 / double(total) : 0.0;
+  }
+};
@@ -8,10 +8,22 @@
 //
 #pragma once
 
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <cstring>
 #ifdef RV32I_DEBUG
 #include <cstdio>
 #endif
+#ifdef RV32I_STATISTICS
+#include <unordered_map>
+#endif
+#ifdef RV32I_THREADED
+#include <vector>
+#ifdef RV32I_DEBUG
+#error "RV32I_DEBUG is not supported by the threaded engine"
+#endif
+#endif
 
 namespace rv32i {
 
@@ -21,39 +33,686 @@ enum class bus_op_width { BYTE = 1, HALF_WORD = 2, WORD = 4 };
 
 using bus_status = uint32_t;
 
+// returned by a bus 'load' that completed while the device waits for I/O
+//  e.g. no input available; the load retires and 'cpu::run' stops
+static bus_status constexpr BUS_IO_WAIT = 0xffff'ffff;
+
 using bus = auto (*)(uint32_t address, bus_op_width op_width, bool is_store,
                      uint32_t &data) -> bus_status;
 
-class cpu final {
+// memory and I/O outside of RAM as seen by 'cpu'
+//  'fetch' is an instruction read and 'load' a data read
+template <typename T>
+concept bus_interface =
+    requires(T &b, uint32_t const address, bus_op_width const op_width,
+             uint32_t &data) {
+      { b.load(address, op_width, data) } -> same_as<bus_status>;
+      { b.store(address, op_width, uint32_t{}) } -> same_as<bus_status>;
+      { b.fetch(address, data) } -> same_as<bus_status>;
+    };
+
+// adapts a 'bus' callback to 'bus_interface'
+class callback_bus final {
+  bus callback_{};
+
+public:
+  callback_bus(bus const callback) : callback_{callback} {}
+
+  auto load(uint32_t const address, bus_op_width const op_width,
+            uint32_t &data) const -> bus_status {
+    return callback_(address, op_width, false, data);
+  }
+
+  auto store(uint32_t const address, bus_op_width const op_width,
+             uint32_t data) const -> bus_status {
+    return callback_(address, op_width, true, data);
+  }
+
+  auto fetch(uint32_t const address, uint32_t &data) const -> bus_status {
+    return callback_(address, bus_op_width::WORD, false, data);
+  }
+};
+
+// note: RAM is accessed directly in host byte order
+static_assert(endian::native == endian::little);
+
+// 2 ^ 14 = 16 K decoded instructions (64 KB of code) in cache
+static uint32_t constexpr DECODE_CACHE_INDEX_BITWIDTH = 14;
+
+#ifdef RV32I_THREADED
+// 2 ^ 14 = 16 K superblocks looked up by start address
+static uint32_t constexpr BLOCK_INDEX_BITWIDTH = 14;
+
+// instructions per superblock when no branch or 'jalr' ends it earlier
+static uint32_t constexpr BLOCK_MAX_INSTRUCTIONS = 64;
+
+// threaded instructions in all translated blocks before flushing
+static uint32_t constexpr THREADED_CODE_SIZE = 1u << 16;
+#endif
+
+// instruction operations flattened from opcode, funct3 and funct7
+enum class operation : uint8_t {
+  LUI,
+  AUIPC,
+  JAL,
+  JALR,
+  BEQ,
+  BNE,
+  BLT,
+  BGE,
+  BLTU,
+  BGEU,
+  LB,
+  LH,
+  LW,
+  LBU,
+  LHU,
+  SB,
+  SH,
+  SW,
+  ADDI,
+  SLTI,
+  SLTIU,
+  XORI,
+  ORI,
+  ANDI,
+  SLLI,
+  SRLI,
+  SRAI,
+  ADD,
+  SUB,
+  SLL,
+  SLT,
+  SLTU,
+  XOR,
+  SRL,
+  SRA,
+  OR,
+  AND,
+  ILLEGAL // 'imm' is the status returned by 'tick()'
+};
+
+// instruction decoded once and cached by address
+struct decoded_instruction final {
+  uint32_t pc{0xffff'ffff}; // address of instruction or not decoded
+  operation op{operation::ILLEGAL};
+  uint8_t rd{};
+  uint8_t rs1{};
+  uint8_t rs2{};
+  int32_t imm{9}; // immediate, shift amount or status of 'ILLEGAL'
+#ifdef RV32I_DEBUG
+  uint32_t instruction{};
+#endif
+};
+
+// bus that also observes execution
+//  'on_execute' is called before an instruction executes with the registers
+//  x0..x31 and 'on_load', 'on_store' after every data access including those
+//  done directly in RAM
+//  note: 'rd' is 32 instead of 0 in threaded code
+template <typename T>
+concept execution_observer =
+    requires(T &b, decoded_instruction const &d, int32_t const *regs,
+             uint32_t const address, bus_op_width const op_width,
+             uint32_t const data) {
+      b.on_execute(d, regs);
+      b.on_load(address, op_width, data);
+      b.on_store(address, op_width, data);
+    };
 
-  bus bus_{};
+#ifdef RV32I_STATISTICS
+// counts of executed instructions
+//  note: enabled at compile time with 'RV32I_STATISTICS'
+struct statistics final {
+  struct branch final {
+    uint64_t taken{};
+    uint64_t not_taken{};
+  };
+
+  uint64_t operations[uint32_t(operation::ILLEGAL) + 1]{}; // by 'operation'
+  unordered_map<uint32_t, branch> branches;                // by address
+};
+#endif
+
+// reason 'cpu::run' returned
+enum class stop_reason : uint8_t { BUDGET_EXHAUSTED, IO_WAIT, ERROR };
+
+struct run_result final {
+  uint64_t executed{}; // retired instructions
+  stop_reason reason{stop_reason::BUDGET_EXHAUSTED};
+  uint32_t error{}; // status when 'reason' is 'ERROR'
+};
+
+// note: 'bus_type' is a template parameter so that bus accesses can be inlined
+template <bus_interface bus_type = callback_bus> class cpu final {
+
+  bus_type bus_;
+  uint8_t *ram_{};
+  uint32_t ram_size_{};
   uint32_t pc_{};
-  int32_t regs_[32]{};
+  int32_t regs_[33]{};
+  // note: x0 to x31 and a sink for writes to x0 in threaded code
+  decoded_instruction decoded_[1u << DECODE_CACHE_INDEX_BITWIDTH]{};
+#ifdef RV32I_STATISTICS
+  statistics statistics_;
+#endif
+#ifdef RV32I_THREADED
+  struct threaded_instruction final {
+    void const *handler{};
+    decoded_instruction d{};
+    // index in 'threaded_' of successor block when not taken and taken or
+    // the last target of 'jalr'
+    uint32_t link[2]{NOT_LINKED, NOT_LINKED};
+  };
+
+  static uint32_t constexpr NOT_LINKED = 0xffff'ffff;
+
+  struct block final {
+    uint32_t pc{0xffff'ffff}; // start address of block or not translated
+    uint32_t offset{};        // index of first instruction in 'threaded_'
+  };
+
+  vector<threaded_instruction> threaded_ =
+      vector<threaded_instruction>(THREADED_CODE_SIZE);
+  uint32_t threaded_size_{};
+  vector<block> blocks_ = vector<block>(1u << BLOCK_INDEX_BITWIDTH);
+#endif
 
 public:
   using status = uint32_t;
 
-  cpu(bus const bus_callback, uint32_t const initial_pc = 0)
-      : bus_{bus_callback}, pc_{initial_pc} {}
+  cpu(bus_type const bus_model, uint32_t const initial_pc = 0)
+      : bus_{bus_model}, pc_{initial_pc} {}
+
+  // accesses within 'ram_data' are done directly and others through
+  // 'bus_model'
+  cpu(bus_type const bus_model, uint8_t *const ram_data,
+      uint32_t const ram_size, uint32_t const initial_pc = 0)
+      : bus_{bus_model}, ram_{ram_data}, ram_size_{ram_size},
+        pc_{initial_pc} {}
+
+#ifndef RV32I_THREADED
+  // executes at most 'max_instructions' instructions
+  auto run(uint64_t const max_instructions) -> run_result {
+    using enum stop_reason;
+    run_result result{max_instructions, BUDGET_EXHAUSTED};
+    uint32_t pc = pc_;
+    for (uint64_t executed = 0; executed < max_instructions; ++executed) {
+      if (status const s = execute(pc)) [[unlikely]] {
+        result = s == BUS_IO_WAIT ? run_result{executed + 1, IO_WAIT}
+                                  : run_result{executed, ERROR, s};
+        break;
+      }
+    }
+    pc_ = pc;
+    return result;
+  }
+#else
+  // executes at most 'max_instructions' instructions
+  //  superblocks are translated to threaded code dispatched with computed
+  //  goto and run without returning to the caller between blocks
+  //  blocks are linked to their successors once the target is known
+  auto run(uint64_t const max_instructions) -> run_result {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+    // in the order of 'operation' followed by end of block
+    static void const *const handlers[] = {
+        &&op_lui,  &&op_auipc, &&op_jal,     &&op_jalr, &&op_beq,
+        &&op_bne,  &&op_blt,   &&op_bge,     &&op_bltu, &&op_bgeu,
+        &&op_lb,   &&op_lh,    &&op_lw,      &&op_lbu,  &&op_lhu,
+        &&op_sb,   &&op_sh,    &&op_sw,      &&op_addi, &&op_slti,
+        &&op_sltiu, &&op_xori, &&op_ori,     &&op_andi, &&op_slli,
+        &&op_srli, &&op_srai,  &&op_add,     &&op_sub,  &&op_sll,
+        &&op_slt,  &&op_sltu,  &&op_xor,     &&op_srl,  &&op_sra,
+        &&op_or,   &&op_and,   &&op_illegal, &&end_of_block};
+
+    using enum bus_op_width;
+    using enum stop_reason;
+
+    uint64_t instruction_count = max_instructions; // remaining
+    uint32_t pc = pc_;
+    threaded_instruction *t = nullptr;
+    uint32_t value = 0;
+    bus_status load_status = 0;
+    // instruction that is linked to the next block when it is looked up
+    threaded_instruction *link_from = nullptr;
+    uint32_t link_index = 0;
+
+// next instruction in block unless instruction count has been executed
+#define RV32I_DISPATCH                                                         \
+  ++t;                                                                         \
+  if (--instruction_count == 0) {                                              \
+    pc_ = t->d.pc;                                                             \
+    return {max_instructions, BUDGET_EXHAUSTED};                               \
+  }                                                                            \
+  goto *t->handler
+
+// next instruction after a load unless the load waits for I/O
+#define RV32I_LOADED                                                           \
+  if (load_status == BUS_IO_WAIT) [[unlikely]] {                               \
+    goto io_wait;                                                              \
+  }                                                                            \
+  RV32I_DISPATCH
+
+// stop at current instruction with error status
+#define RV32I_ERROR(error_status)                                              \
+  pc_ = t->d.pc;                                                               \
+  return {max_instructions - instruction_count, ERROR, error_status}
+
+// continue at 'pc' with the block linked by 'link[index]' or look it up
+#define RV32I_BRANCH(index)                                                    \
+  if (--instruction_count == 0) {                                              \
+    pc_ = pc;                                                                  \
+    return {max_instructions, BUDGET_EXHAUSTED};                               \
+  }                                                                            \
+  if (uint32_t const l = t->link[index]; l != NOT_LINKED) {                    \
+    t = &threaded_[l];                                                         \
+    goto *t->handler;                                                          \
+  }                                                                            \
+  link_from = t;                                                               \
+  link_index = index;                                                          \
+  goto next_block
+
+  next_block:
+    if (instruction_count == 0) {
+      pc_ = pc;
+      return {max_instructions, BUDGET_EXHAUSTED};
+    }
+    {
+      block const &b = blocks_[block_index(pc)];
+      uint32_t offset = b.offset;
+      if (b.pc != pc) [[unlikely]] {
+        uint32_t const size_before_translate = threaded_size_;
+        uint32_t count = 0;
+        if (status const s = translate(pc, offset, count)) {
+          pc_ = pc;
+          return {max_instructions - instruction_count, ERROR, s};
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+          threaded_instruction &ti = threaded_[offset + i];
+#ifdef RV32I_STATISTICS
+          ti.handler = &&observe;
+#else
+          ti.handler = execution_observer<bus_type>
+                           ? &&observe
+                           : handlers[uint32_t(ti.d.op)];
+#endif
+        }
+        threaded_[offset + count].handler = &&end_of_block;
+        if (offset < size_before_translate) {
+          // threaded code was flushed
+          link_from = nullptr;
+        }
+      }
+      if (link_from) {
+        link_from->link[link_index] = offset;
+        link_from = nullptr;
+      }
+      t = &threaded_[offset];
+    }
+    goto *t->handler;
+
+  end_of_block:
+    pc = t->d.pc;
+    if (uint32_t const l = t->link[0]; l != NOT_LINKED) {
+      t = &threaded_[l];
+      goto *t->handler;
+    }
+    link_from = t;
+    link_index = 0;
+    goto next_block;
+
+  op_lui:
+    regs_[t->d.rd] = t->d.imm;
+    RV32I_DISPATCH;
+
+  op_auipc:
+    regs_[t->d.rd] = int32_t(t->d.pc + uint32_t(t->d.imm));
+    RV32I_DISPATCH;
+
+  op_jal:
+    // note: superblock continues at the target
+    regs_[t->d.rd] = int32_t(t->d.pc + 4);
+    RV32I_DISPATCH;
+
+  op_jalr:
+    pc = uint32_t(regs_[t->d.rs1] + t->d.imm);
+    regs_[t->d.rd] = int32_t(t->d.pc + 4);
+    if (t->link[0] != NOT_LINKED && threaded_[t->link[0]].d.pc != pc) {
+      // target differs from last time
+      t->link[0] = NOT_LINKED;
+    }
+    RV32I_BRANCH(0);
+
+  op_beq:
+    if (regs_[t->d.rs1] == regs_[t->d.rs2]) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_bne:
+    if (regs_[t->d.rs1] != regs_[t->d.rs2]) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_blt:
+    if (regs_[t->d.rs1] < regs_[t->d.rs2]) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_bge:
+    if (regs_[t->d.rs1] >= regs_[t->d.rs2]) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_bltu:
+    if (uint32_t(regs_[t->d.rs1]) < uint32_t(regs_[t->d.rs2])) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_bgeu:
+    if (uint32_t(regs_[t->d.rs1]) >= uint32_t(regs_[t->d.rs2])) {
+      pc = uint32_t(int32_t(t->d.pc) + t->d.imm);
+      RV32I_BRANCH(1);
+    }
+    pc = t->d.pc + 4;
+    RV32I_BRANCH(0);
+
+  op_lb:
+    load_status = load<BYTE>(uint32_t(regs_[t->d.rs1] + t->d.imm), value);
+    if (load_status && load_status != BUS_IO_WAIT) [[unlikely]] {
+      RV32I_ERROR(1400 + load_status);
+    }
+    regs_[t->d.rd] = int32_t(value & 0x80 ? 0xffff'ff00 | value : value);
+    RV32I_LOADED;
+
+  op_lh:
+    load_status = load<HALF_WORD>(uint32_t(regs_[t->d.rs1] + t->d.imm), value);
+    if (load_status && load_status != BUS_IO_WAIT) [[unlikely]] {
+      RV32I_ERROR(1500 + load_status);
+    }
+    regs_[t->d.rd] = int32_t(value & 0x8000 ? 0xffff'0000 | value : value);
+    RV32I_LOADED;
+
+  op_lw:
+    load_status = load<WORD>(uint32_t(regs_[t->d.rs1] + t->d.imm), value);
+    if (load_status && load_status != BUS_IO_WAIT) [[unlikely]] {
+      RV32I_ERROR(1600 + load_status);
+    }
+    regs_[t->d.rd] = int32_t(value);
+    RV32I_LOADED;
+
+  op_lbu:
+    load_status = load<BYTE>(uint32_t(regs_[t->d.rs1] + t->d.imm), value);
+    if (load_status && load_status != BUS_IO_WAIT) [[unlikely]] {
+      RV32I_ERROR(1700 + load_status);
+    }
+    regs_[t->d.rd] = int32_t(value);
+    RV32I_LOADED;
+
+  op_lhu:
+    load_status = load<HALF_WORD>(uint32_t(regs_[t->d.rs1] + t->d.imm), value);
+    if (load_status && load_status != BUS_IO_WAIT) [[unlikely]] {
+      RV32I_ERROR(1800 + load_status);
+    }
+    regs_[t->d.rd] = int32_t(value);
+    RV32I_LOADED;
+
+  op_sb: {
+    uint32_t const address = uint32_t(regs_[t->d.rs1] + t->d.imm);
+    value = uint32_t(regs_[t->d.rs2]);
+    if (bus_status const s = store<BYTE>(address, value)) {
+      RV32I_ERROR(1100 + s);
+    }
+    if (invalidate_decoded(address, BYTE)) [[unlikely]] {
+      // store into translated code
+      flush_threaded();
+      link_from = nullptr;
+      pc = t->d.pc + 4;
+      --instruction_count;
+      goto next_block;
+    }
+    RV32I_DISPATCH;
+  }
+
+  op_sh: {
+    uint32_t const address = uint32_t(regs_[t->d.rs1] + t->d.imm);
+    value = uint32_t(regs_[t->d.rs2]);
+    if (bus_status const s = store<HALF_WORD>(address, value)) {
+      RV32I_ERROR(1200 + s);
+    }
+    if (invalidate_decoded(address, HALF_WORD)) [[unlikely]] {
+      flush_threaded();
+      link_from = nullptr;
+      pc = t->d.pc + 4;
+      --instruction_count;
+      goto next_block;
+    }
+    RV32I_DISPATCH;
+  }
+
+  op_sw: {
+    uint32_t const address = uint32_t(regs_[t->d.rs1] + t->d.imm);
+    value = uint32_t(regs_[t->d.rs2]);
+    if (bus_status const s = store<WORD>(address, value)) {
+      RV32I_ERROR(1300 + s);
+    }
+    if (invalidate_decoded(address, WORD)) [[unlikely]] {
+      flush_threaded();
+      link_from = nullptr;
+      pc = t->d.pc + 4;
+      --instruction_count;
+      goto next_block;
+    }
+    RV32I_DISPATCH;
+  }
+
+  op_addi:
+    regs_[t->d.rd] = regs_[t->d.rs1] + t->d.imm;
+    RV32I_DISPATCH;
+
+  op_slti:
+    regs_[t->d.rd] = regs_[t->d.rs1] < t->d.imm ? 1 : 0;
+    RV32I_DISPATCH;
+
+  op_sltiu:
+    regs_[t->d.rd] = uint32_t(regs_[t->d.rs1]) < uint32_t(t->d.imm) ? 1 : 0;
+    RV32I_DISPATCH;
+
+  op_xori:
+    regs_[t->d.rd] = regs_[t->d.rs1] ^ t->d.imm;
+    RV32I_DISPATCH;
+
+  op_ori:
+    regs_[t->d.rd] = regs_[t->d.rs1] | t->d.imm;
+    RV32I_DISPATCH;
+
+  op_andi:
+    regs_[t->d.rd] = regs_[t->d.rs1] & t->d.imm;
+    RV32I_DISPATCH;
+
+  op_slli:
+    regs_[t->d.rd] = regs_[t->d.rs1] << t->d.imm;
+    RV32I_DISPATCH;
+
+  op_srli:
+    regs_[t->d.rd] = int32_t(uint32_t(regs_[t->d.rs1]) >> t->d.imm);
+    RV32I_DISPATCH;
+
+  op_srai:
+    regs_[t->d.rd] = regs_[t->d.rs1] >> t->d.imm;
+    RV32I_DISPATCH;
+
+  op_add:
+    regs_[t->d.rd] = regs_[t->d.rs1] + regs_[t->d.rs2];
+    RV32I_DISPATCH;
+
+  op_sub:
+    regs_[t->d.rd] = regs_[t->d.rs1] - regs_[t->d.rs2];
+    RV32I_DISPATCH;
+
+  op_sll:
+    regs_[t->d.rd] = regs_[t->d.rs1] << (regs_[t->d.rs2] & 0x1f);
+    RV32I_DISPATCH;
+
+  op_slt:
+    regs_[t->d.rd] = regs_[t->d.rs1] < regs_[t->d.rs2] ? 1 : 0;
+    RV32I_DISPATCH;
+
+  op_sltu:
+    regs_[t->d.rd] =
+        uint32_t(regs_[t->d.rs1]) < uint32_t(regs_[t->d.rs2]) ? 1 : 0;
+    RV32I_DISPATCH;
+
+  op_xor:
+    regs_[t->d.rd] = regs_[t->d.rs1] ^ regs_[t->d.rs2];
+    RV32I_DISPATCH;
+
+  op_srl:
+    regs_[t->d.rd] =
+        int32_t(uint32_t(regs_[t->d.rs1]) >> (regs_[t->d.rs2] & 0x1f));
+    RV32I_DISPATCH;
+
+  op_sra:
+    regs_[t->d.rd] = regs_[t->d.rs1] >> (regs_[t->d.rs2] & 0x1f);
+    RV32I_DISPATCH;
+
+  op_or:
+    regs_[t->d.rd] = regs_[t->d.rs1] | regs_[t->d.rs2];
+    RV32I_DISPATCH;
+
+  op_and:
+    regs_[t->d.rd] = regs_[t->d.rs1] & regs_[t->d.rs2];
+    RV32I_DISPATCH;
+
+  op_illegal:
+    RV32I_ERROR(status(t->d.imm));
+
+  observe:
+    // handler of instructions when bus observes execution or statistics are
+    // enabled
+#ifdef RV32I_STATISTICS
+    count(t->d);
+#endif
+    if constexpr (execution_observer<bus_type>) {
+      bus_.on_execute(t->d, regs_);
+    }
+    goto *handlers[uint32_t(t->d.op)];
+
+  io_wait:
+    // load at 't' retired
+    pc_ = t->d.pc + 4;
+    return {max_instructions - instruction_count + 1, IO_WAIT};
+
+#undef RV32I_DISPATCH
+#undef RV32I_LOADED
+#undef RV32I_ERROR
+#undef RV32I_BRANCH
+#pragma GCC diagnostic pop
+  }
+#endif
+
+  // executes one instruction and returns error status or 0
+  auto tick() -> status { return run(1).error; }
+
+  auto reg(uint32_t const num) const -> int32_t { return regs_[num]; }
+  auto set_reg(uint32_t const num, int32_t const value) -> void {
+    regs_[num] = value;
+  }
+  auto pc() const -> uint32_t { return pc_; }
+
+#ifdef RV32I_STATISTICS
+  auto execution_statistics() const -> statistics const & {
+    return statistics_;
+  }
+#endif
+
+private:
+#ifdef RV32I_STATISTICS
+  // counts instruction 'd' before it executes
+  auto count(decoded_instruction const &d) -> void {
+    using enum operation;
+    ++statistics_.operations[uint32_t(d.op)];
+    bool taken = false;
+    switch (d.op) {
+    case BEQ:
+      taken = regs_[d.rs1] == regs_[d.rs2];
+      break;
+    case BNE:
+      taken = regs_[d.rs1] != regs_[d.rs2];
+      break;
+    case BLT:
+      taken = regs_[d.rs1] < regs_[d.rs2];
+      break;
+    case BGE:
+      taken = regs_[d.rs1] >= regs_[d.rs2];
+      break;
+    case BLTU:
+      taken = uint32_t(regs_[d.rs1]) < uint32_t(regs_[d.rs2]);
+      break;
+    case BGEU:
+      taken = uint32_t(regs_[d.rs1]) >= uint32_t(regs_[d.rs2]);
+      break;
+    default:
+      return;
+    }
+    statistics::branch &b = statistics_.branches[d.pc];
+    ++(taken ? b.taken : b.not_taken);
+  }
+#endif
+
+#ifndef RV32I_THREADED
+  //
+  // interpreter
+  //
+
+  // executes instruction at 'pc' and advances 'pc' unless error
+  //  returns 0, 'BUS_IO_WAIT' if a load waits for I/O or error status
+  auto execute(uint32_t &pc) -> status {
 
-  auto tick() -> status {
     regs_[0] = 0;
-    uint32_t next_pc = pc_ + 4;
-    uint32_t instruction = 0;
-    if (bus_status const s =
-            bus_(pc_, bus_op_width::WORD, false, instruction)) {
-      return 1000 + s;
+    uint32_t next_pc = pc + 4;
+    status retired = 0; // 'BUS_IO_WAIT' when a load waits for I/O
+    decoded_instruction &d = decoded_[decode_cache_index(pc)];
+    if (d.pc != pc) [[unlikely]] {
+      uint32_t instruction = 0;
+      if (bus_status const s = fetch(pc, instruction)) {
+        return 1000 + s;
+      }
+      d = decode(pc, instruction);
+    }
+    if constexpr (execution_observer<bus_type>) {
+      bus_.on_execute(d, regs_);
     }
+#ifdef RV32I_STATISTICS
+    count(d);
+#endif
 #ifdef RV32I_DEBUG
-    printf("pc 0x%08x instr 0x%08x ", pc_, instruction);
+    printf("pc 0x%08x instr 0x%08x ", pc, d.instruction);
 #endif
-    uint32_t const opcode = OPCODE_from(instruction);
-    switch (opcode) {
+    uint32_t const rd = d.rd;
+    uint32_t const rs1 = d.rs1;
+    uint32_t const rs2 = d.rs2;
+    using enum operation;
+    using enum bus_op_width;
+    switch (d.op) {
     //-----------------------------------------------------------------------
-    case OPCODE_LUI: //                                                   LUI
-    {
-      uint32_t const rd = RD_from(instruction);
-      uint32_t const U_imm20 = U_imm20_from(instruction);
+    case LUI: {
+      uint32_t const U_imm20 = uint32_t(d.imm);
 #ifdef RV32I_DEBUG
       printf("lui x%u, 0x%x\n", rd, U_imm20 >> 12);
 #endif
@@ -61,341 +720,299 @@ public:
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_LOGICAL_IMM: //                         logical ops immediate
-    {
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rd = RD_from(instruction);
-      int32_t const I_imm12 = I_imm12_from(instruction);
-      uint32_t const funct3 = FUNCT3_from(instruction);
-      switch (funct3) {
-      case FUNCT3_ADDI: {
+    case ADDI: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("addi x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("addi x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = regs_[rs1] + I_imm12;
-        break;
-      }
-      case FUNCT3_SLTI: {
+      regs_[rd] = regs_[rs1] + I_imm12;
+      break;
+    }
+    case SLTI: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("slti x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("slti x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = regs_[rs1] < I_imm12 ? 1 : 0;
-        break;
-      }
-      case FUNCT3_SLTIU: {
+      regs_[rd] = regs_[rs1] < I_imm12 ? 1 : 0;
+      break;
+    }
+    case SLTIU: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("sltiu x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("sltiu x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = uint32_t(regs_[rs1]) < uint32_t(I_imm12) ? 1 : 0;
-        break;
-      }
-      case FUNCT3_XORI: {
+      regs_[rd] = uint32_t(regs_[rs1]) < uint32_t(I_imm12) ? 1 : 0;
+      break;
+    }
+    case XORI: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("xori x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("xori x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = regs_[rs1] ^ I_imm12;
-        break;
-      }
-      case FUNCT3_ORI: {
+      regs_[rd] = regs_[rs1] ^ I_imm12;
+      break;
+    }
+    case ORI: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("ori x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("ori x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = regs_[rs1] | I_imm12;
-        break;
-      }
-      case FUNCT3_ANDI: {
+      regs_[rd] = regs_[rs1] | I_imm12;
+      break;
+    }
+    case ANDI: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
-        printf("andi x%u, x%u, %d\n", rd, rs1, I_imm12);
+      printf("andi x%u, x%u, %d\n", rd, rs1, I_imm12);
 #endif
-        regs_[rd] = regs_[rs1] & I_imm12;
-        break;
-      }
-      case FUNCT3_SLLI: {
-        uint32_t const shift_amount = RS2_from(instruction);
+      regs_[rd] = regs_[rs1] & I_imm12;
+      break;
+    }
+    case SLLI: {
+      uint32_t const shift_amount = uint32_t(d.imm);
 #ifdef RV32I_DEBUG
-        printf("slli x%u, x%u, %u\n", rd, rs1, shift_amount);
+      printf("slli x%u, x%u, %u\n", rd, rs1, shift_amount);
 #endif
-        regs_[rd] = regs_[rs1] << shift_amount;
-        break;
-      }
-      case FUNCT3_SRLI_SRAI: {
-        uint32_t const shift_amount = RS2_from(instruction);
-        uint32_t const funct7 = FUNCT7_from(instruction);
-        switch (funct7) {
-        case FUNCT7_SRLI: {
+      regs_[rd] = regs_[rs1] << shift_amount;
+      break;
+    }
+    case SRLI: {
+      uint32_t const shift_amount = uint32_t(d.imm);
 #ifdef RV32I_DEBUG
-          printf("srli x%u, x%u, %u\n", rd, rs1, shift_amount);
+      printf("srli x%u, x%u, %u\n", rd, rs1, shift_amount);
 #endif
-          regs_[rd] = int32_t(uint32_t(regs_[rs1]) >> shift_amount);
-          break;
-        }
-        case FUNCT7_SRAI: {
+      regs_[rd] = int32_t(uint32_t(regs_[rs1]) >> shift_amount);
+      break;
+    }
+    case SRAI: {
+      uint32_t const shift_amount = uint32_t(d.imm);
 #ifdef RV32I_DEBUG
-          printf("srai x%u, x%u, %u\n", rd, rs1, shift_amount);
+      printf("srai x%u, x%u, %u\n", rd, rs1, shift_amount);
 #endif
-          regs_[rd] = regs_[rs1] >> shift_amount;
-          break;
-        }
-        default:
-          return 1;
-        }
-        break;
-      }
-      default:
-        return 2;
-      }
+      regs_[rd] = regs_[rs1] >> shift_amount;
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_LOGICAL: //                                       logical ops
-    {
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rs2 = RS2_from(instruction);
-      uint32_t const rd = RD_from(instruction);
-      uint32_t const funct3 = FUNCT3_from(instruction);
-      switch (funct3) {
-      case FUNCT3_ADD_SUB: {
-        uint32_t const FUNCT7 = FUNCT7_from(instruction);
-        switch (FUNCT7) {
-        case FUNCT7_ADD: {
+    case ADD: {
 #ifdef RV32I_DEBUG
-          printf("add x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("add x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-          regs_[rd] = regs_[rs1] + regs_[rs2];
-          break;
-        }
-        case FUNCT7_SUB: {
+      regs_[rd] = regs_[rs1] + regs_[rs2];
+      break;
+    }
+    case SUB: {
 #ifdef RV32I_DEBUG
-          printf("sub x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("sub x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-          regs_[rd] = regs_[rs1] - regs_[rs2];
-          break;
-        }
-        default:
-          return 3;
-        }
-        break;
-      }
-      case FUNCT3_SLL: {
+      regs_[rd] = regs_[rs1] - regs_[rs2];
+      break;
+    }
+    case SLL: {
 #ifdef RV32I_DEBUG
-        printf("sll x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("sll x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = regs_[rs1] << (regs_[rs2] & 0x1f);
-        break;
-      }
-      case FUNCT3_SLT: {
+      regs_[rd] = regs_[rs1] << (regs_[rs2] & 0x1f);
+      break;
+    }
+    case SLT: {
 #ifdef RV32I_DEBUG
-        printf("slt x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("slt x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = regs_[rs1] < regs_[rs2] ? 1 : 0;
-        break;
-      }
-      case FUNCT3_SLTU: {
+      regs_[rd] = regs_[rs1] < regs_[rs2] ? 1 : 0;
+      break;
+    }
+    case SLTU: {
 #ifdef RV32I_DEBUG
-        printf("sltu x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("sltu x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = uint32_t(regs_[rs1]) < uint32_t(regs_[rs2]) ? 1 : 0;
-        break;
-      }
-      case FUNCT3_XOR: {
+      regs_[rd] = uint32_t(regs_[rs1]) < uint32_t(regs_[rs2]) ? 1 : 0;
+      break;
+    }
+    case XOR: {
 #ifdef RV32I_DEBUG
-        printf("xor x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("xor x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = regs_[rs1] ^ regs_[rs2];
-        break;
-      }
-      case FUNCT3_SRL_SRA: {
-        uint32_t const shift_amount = regs_[rs2] & 0x1f;
-        uint32_t const funct7 = FUNCT7_from(instruction);
-        switch (funct7) {
-        case FUNCT7_SRL: {
+      regs_[rd] = regs_[rs1] ^ regs_[rs2];
+      break;
+    }
+    case SRL: {
 #ifdef RV32I_DEBUG
-          printf("srl x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("srl x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-          regs_[rd] = int32_t(uint32_t(regs_[rs1]) >> shift_amount);
-          break;
-        }
-        case FUNCT7_SRA: {
+      regs_[rd] = int32_t(uint32_t(regs_[rs1]) >> (regs_[rs2] & 0x1f));
+      break;
+    }
+    case SRA: {
 #ifdef RV32I_DEBUG
-          printf("sra x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("sra x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-          regs_[rd] = regs_[rs1] >> shift_amount;
-          break;
-        }
-        default:
-          return 4;
-        }
-        break;
-      }
-      case FUNCT3_OR: {
+      regs_[rd] = regs_[rs1] >> (regs_[rs2] & 0x1f);
+      break;
+    }
+    case OR: {
 #ifdef RV32I_DEBUG
-        printf("or x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("or x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = regs_[rs1] | regs_[rs2];
-        break;
-      }
-      case FUNCT3_AND: {
+      regs_[rd] = regs_[rs1] | regs_[rs2];
+      break;
+    }
+    case AND: {
 #ifdef RV32I_DEBUG
-        printf("and x%u, x%u, x%u\n", rd, rs1, rs2);
+      printf("and x%u, x%u, x%u\n", rd, rs1, rs2);
 #endif
-        regs_[rd] = regs_[rs1] & regs_[rs2];
-        break;
-      }
-      default:
-        return 5;
-      }
+      regs_[rd] = regs_[rs1] & regs_[rs2];
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_STORE: //                                               store
-    {
-      using enum bus_op_width;
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rs2 = RS2_from(instruction);
-      int32_t const S_imm12 = S_imm12_from(instruction);
+    case SB: {
+      int32_t const S_imm12 = d.imm;
       uint32_t const address = uint32_t(regs_[rs1] + S_imm12);
       uint32_t value = uint32_t(regs_[rs2]);
-      uint32_t const funct3 = FUNCT3_from(instruction);
-      switch (funct3) {
-      case FUNCT3_SB: {
 #ifdef RV32I_DEBUG
-        printf("sb x%u, %d(x%u)\n", rs2, S_imm12, rs1);
+      printf("sb x%u, %d(x%u)\n", rs2, S_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, BYTE, true, value)) {
-          return 1100 + s;
-        }
-        break;
+      if (bus_status const s = store<BYTE>(address, value)) {
+        return 1100 + s;
       }
-      case FUNCT3_SH: {
+      invalidate_decoded(address, BYTE);
+      break;
+    }
+    case SH: {
+      int32_t const S_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + S_imm12);
+      uint32_t value = uint32_t(regs_[rs2]);
 #ifdef RV32I_DEBUG
-        printf("sh x%u, %d(x%u)\n", rs2, S_imm12, rs1);
+      printf("sh x%u, %d(x%u)\n", rs2, S_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, HALF_WORD, true, value)) {
-          return 1200 + s;
-        }
-        break;
+      if (bus_status const s = store<HALF_WORD>(address, value)) {
+        return 1200 + s;
       }
-      case FUNCT3_SW: {
+      invalidate_decoded(address, HALF_WORD);
+      break;
+    }
+    case SW: {
+      int32_t const S_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + S_imm12);
+      uint32_t value = uint32_t(regs_[rs2]);
 #ifdef RV32I_DEBUG
-        printf("sw x%u, %d(x%u)\n", rs2, S_imm12, rs1);
+      printf("sw x%u, %d(x%u)\n", rs2, S_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, WORD, true, value)) {
-          return 1300 + s;
-        }
-        break;
-      }
-      default:
-        return 6;
+      if (bus_status const s = store<WORD>(address, value)) {
+        return 1300 + s;
       }
+      invalidate_decoded(address, WORD);
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_LOAD: //                                                 load
-    {
-      using enum bus_op_width;
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rd = RD_from(instruction);
-      int32_t const I_imm12 = I_imm12_from(instruction);
+    case LB: {
+      int32_t const I_imm12 = d.imm;
       uint32_t const address = uint32_t(regs_[rs1] + I_imm12);
       uint32_t value = 0;
-      uint32_t const funct3 = FUNCT3_from(instruction);
-      switch (funct3) {
-      case FUNCT3_LB: {
 #ifdef RV32I_DEBUG
-        printf("lb x%u, %d(x%u)\n", rd, I_imm12, rs1);
+      printf("lb x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, BYTE, false, value)) {
-          return 1400 + s;
-        }
-        regs_[rd] = int32_t(value & 0x80 ? 0xffff'ff00 | value : value);
-        break;
+      bus_status const s = load<BYTE>(address, value);
+      if (s && s != BUS_IO_WAIT) [[unlikely]] {
+        return 1400 + s;
       }
-      case FUNCT3_LH: {
+      retired = s;
+      regs_[rd] = int32_t(value & 0x80 ? 0xffff'ff00 | value : value);
+      break;
+    }
+    case LH: {
+      int32_t const I_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + I_imm12);
+      uint32_t value = 0;
 #ifdef RV32I_DEBUG
-        printf("lh x%u, %d(x%u)\n", rd, I_imm12, rs1);
+      printf("lh x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, HALF_WORD, false, value)) {
-          return 1500 + s;
-        }
-        regs_[rd] = int32_t(value & 0x8000 ? 0xffff'0000 | value : value);
-        break;
+      bus_status const s = load<HALF_WORD>(address, value);
+      if (s && s != BUS_IO_WAIT) [[unlikely]] {
+        return 1500 + s;
       }
-      case FUNCT3_LW: {
+      retired = s;
+      regs_[rd] = int32_t(value & 0x8000 ? 0xffff'0000 | value : value);
+      break;
+    }
+    case LW: {
+      int32_t const I_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + I_imm12);
+      uint32_t value = 0;
 #ifdef RV32I_DEBUG
-        printf("lw x%u, %d(x%u)\n", rd, I_imm12, rs1);
+      printf("lw x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, WORD, false, value)) {
-          return 1600 + s;
-        }
-        regs_[rd] = int32_t(value);
+      bus_status const s = load<WORD>(address, value);
+      if (s && s != BUS_IO_WAIT) [[unlikely]] {
+        return 1600 + s;
+      }
+      retired = s;
+      regs_[rd] = int32_t(value);
 #ifdef RV32I_DEBUG
-        printf("  x%u=0x%x\n", rs1, regs_[rs1]);
-        printf("  x%u=0x%x\n", rd, regs_[rd]);
+      printf("  x%u=0x%x\n", rs1, regs_[rs1]);
+      printf("  x%u=0x%x\n", rd, regs_[rd]);
 #endif
-        break;
-      }
-      case FUNCT3_LBU: {
+      break;
+    }
+    case LBU: {
+      int32_t const I_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + I_imm12);
+      uint32_t value = 0;
 #ifdef RV32I_DEBUG
-        printf("lbu x%u, %d(x%u)\n", rd, I_imm12, rs1);
+      printf("lbu x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, BYTE, false, value)) {
-          return 1700 + s;
-        }
-        regs_[rd] = int32_t(value);
-        break;
+      bus_status const s = load<BYTE>(address, value);
+      if (s && s != BUS_IO_WAIT) [[unlikely]] {
+        return 1700 + s;
       }
-      case FUNCT3_LHU: {
+      retired = s;
+      regs_[rd] = int32_t(value);
+      break;
+    }
+    case LHU: {
+      int32_t const I_imm12 = d.imm;
+      uint32_t const address = uint32_t(regs_[rs1] + I_imm12);
+      uint32_t value = 0;
 #ifdef RV32I_DEBUG
-        printf("lhu x%u, %d(x%u)\n", rd, I_imm12, rs1);
+      printf("lhu x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
-        if (bus_status const s = bus_(address, HALF_WORD, false, value)) {
-          return 1800 + s;
-        }
-        regs_[rd] = int32_t(value);
-        break;
-      }
-      default:
-        return 7;
+      bus_status const s = load<HALF_WORD>(address, value);
+      if (s && s != BUS_IO_WAIT) [[unlikely]] {
+        return 1800 + s;
       }
+      retired = s;
+      regs_[rd] = int32_t(value);
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_AUIPC: //                                               AUIPC
-    {
-      uint32_t const rd = RD_from(instruction);
-      uint32_t const U_imm20 = U_imm20_from(instruction);
+    case AUIPC: {
+      uint32_t const U_imm20 = uint32_t(d.imm);
 #ifdef RV32I_DEBUG
       printf("auipc x%u, 0x%x\n", rd, U_imm20 >> 12);
 #endif
-      regs_[rd] = int32_t(pc_ + U_imm20);
+      regs_[rd] = int32_t(pc + U_imm20);
 #ifdef RV32I_DEBUG
       printf("  x%u=0x%x\n", rd, regs_[rd]);
 #endif
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_JAL: //                                                   JAL
-    {
-      uint32_t const rd = RD_from(instruction);
-      int32_t const J_imm20 = J_imm20_from(instruction);
+    case JAL: {
+      int32_t const J_imm20 = d.imm;
 #ifdef RV32I_DEBUG
-      printf("jal x%u, 0x%x\n", rd, pc_ + uint32_t(J_imm20));
+      printf("jal x%u, 0x%x\n", rd, pc + uint32_t(J_imm20));
 #endif
-      regs_[rd] = int32_t(pc_ + 4);
-      next_pc = uint32_t(int32_t(pc_) + J_imm20);
+      regs_[rd] = int32_t(pc + 4);
+      next_pc = uint32_t(int32_t(pc) + J_imm20);
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_JALR: //                                                 JALR
-    {
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rd = RD_from(instruction);
-      int32_t const I_imm12 = I_imm12_from(instruction);
+    case JALR: {
+      int32_t const I_imm12 = d.imm;
 #ifdef RV32I_DEBUG
       printf("jalr x%u, %d(x%u)\n", rd, I_imm12, rs1);
 #endif
       next_pc = uint32_t(regs_[rs1] + I_imm12);
-      regs_[rd] = int32_t(pc_ + 4);
+      regs_[rd] = int32_t(pc + 4);
 #ifdef RV32I_DEBUG
       printf("  x%u=0x%x\n", rs1, regs_[rs1]);
       printf("  imm=%d\n", I_imm12);
@@ -404,91 +1021,462 @@ public:
       break;
     }
     //-----------------------------------------------------------------------
-    case OPCODE_BRANCH: //                                           branches
-    {
-      uint32_t const rs1 = RS1_from(instruction);
-      uint32_t const rs2 = RS2_from(instruction);
-      int32_t const B_imm12 = B_imm12_from(instruction);
-      uint32_t const branch_taken_pc = uint32_t(int32_t(pc_) + B_imm12);
-      uint32_t const funct3 = FUNCT3_from(instruction);
-      switch (funct3) {
-      case FUNCT3_BEQ: {
+    case BEQ: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("beq x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("beq x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (regs_[rs1] == regs_[rs2]) {
-          next_pc = branch_taken_pc;
-        }
-        break;
+      if (regs_[rs1] == regs_[rs2]) {
+        next_pc = branch_taken_pc;
       }
-      case FUNCT3_BNE: {
+      break;
+    }
+    case BNE: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("bne x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("bne x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (regs_[rs1] != regs_[rs2]) {
-          next_pc = branch_taken_pc;
-        }
-        break;
+      if (regs_[rs1] != regs_[rs2]) {
+        next_pc = branch_taken_pc;
       }
-      case FUNCT3_BLT: {
+      break;
+    }
+    case BLT: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("blt x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("blt x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (regs_[rs1] < regs_[rs2]) {
-          next_pc = branch_taken_pc;
-        }
-        break;
+      if (regs_[rs1] < regs_[rs2]) {
+        next_pc = branch_taken_pc;
       }
-      case FUNCT3_BGE: {
+      break;
+    }
+    case BGE: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("bge x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("bge x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (regs_[rs1] >= regs_[rs2]) {
-          next_pc = branch_taken_pc;
-        }
-        break;
+      if (regs_[rs1] >= regs_[rs2]) {
+        next_pc = branch_taken_pc;
       }
-      case FUNCT3_BLTU: {
+      break;
+    }
+    case BLTU: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("bltu x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("bltu x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (uint32_t(regs_[rs1]) < uint32_t(regs_[rs2])) {
-          next_pc = branch_taken_pc;
-        }
+      if (uint32_t(regs_[rs1]) < uint32_t(regs_[rs2])) {
+        next_pc = branch_taken_pc;
+      }
 #ifdef RV32I_DEBUG
-        printf("  x%u=0x%x\n", rs1, regs_[rs1]);
-        printf("  x%u=0x%x\n", rs2, regs_[rs2]);
+      printf("  x%u=0x%x\n", rs1, regs_[rs1]);
+      printf("  x%u=0x%x\n", rs2, regs_[rs2]);
 #endif
-        break;
-      }
-      case FUNCT3_BGEU: {
+      break;
+    }
+    case BGEU: {
+      uint32_t const branch_taken_pc = uint32_t(int32_t(pc) + d.imm);
 #ifdef RV32I_DEBUG
-        printf("bgeu x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
+      printf("bgeu x%u, x%u, 0x%x\n", rs1, rs2, branch_taken_pc);
 #endif
-        if (uint32_t(regs_[rs1]) >= uint32_t(regs_[rs2])) {
-          next_pc = branch_taken_pc;
-        }
-        break;
-      }
-      default:
-        return 8;
+      if (uint32_t(regs_[rs1]) >= uint32_t(regs_[rs2])) {
+        next_pc = branch_taken_pc;
       }
       break;
     }
     //-----------------------------------------------------------------------
+    case ILLEGAL: {
+#ifdef RV32I_DEBUG
+      printf("illegal instruction\n");
+#endif
+      return status(d.imm);
+    }
+    //-----------------------------------------------------------------------
     default:
       return 9;
     }
 
-    pc_ = next_pc;
+    pc = next_pc;
+
+    return retired;
+  }
+#endif
+
+  //
+  // memory access
+  //  direct when within RAM otherwise through bus
+  //
+
+  auto fetch(uint32_t const address, uint32_t &data) -> bus_status {
+    if (uint64_t(address) + 4 <= ram_size_) [[likely]] {
+      memcpy(&data, ram_ + address, 4);
+      return 0;
+    }
+    return bus_.fetch(address, data);
+  }
+
+  template <bus_op_width op_width>
+  auto load(uint32_t const address, uint32_t &data) -> bus_status {
+    bus_status s = 0;
+    if (uint64_t(address) + uint32_t(op_width) <= ram_size_) [[likely]] {
+      data = 0;
+      memcpy(&data, ram_ + address, uint32_t(op_width));
+    } else {
+      s = bus_.load(address, op_width, data);
+    }
+    if constexpr (execution_observer<bus_type>) {
+      if (s == 0 || s == BUS_IO_WAIT) {
+        bus_.on_load(address, op_width, data);
+      }
+    }
+    return s;
+  }
+
+  template <bus_op_width op_width>
+  auto store(uint32_t const address, uint32_t const data) -> bus_status {
+    bus_status s = 0;
+    if (uint64_t(address) + uint32_t(op_width) <= ram_size_) [[likely]] {
+      memcpy(ram_ + address, &data, uint32_t(op_width));
+    } else {
+      s = bus_.store(address, op_width, data);
+    }
+    if constexpr (execution_observer<bus_type>) {
+      if (s == 0) {
+        bus_.on_store(address, op_width, data);
+      }
+    }
+    return s;
+  }
+
+  //
+  // decoded instruction cache
+  //  direct mapped on instruction address
+  //
+
+  static auto constexpr decode_cache_index(uint32_t const address)
+      -> uint32_t {
+    return (address >> 2) & ((1u << DECODE_CACHE_INDEX_BITWIDTH) - 1);
+  }
+
+  // invalidates decoded instructions overlapping a store
+  //  returns true if a decoded instruction was invalidated
+  auto invalidate_decoded(uint32_t const address, bus_op_width const op_width)
+      -> bool {
+    bool invalidated = false;
+    uint32_t const last_address = address + uint32_t(op_width) - 1;
+    decoded_instruction &first = decoded_[decode_cache_index(address)];
+    if ((first.pc >> 2) == (address >> 2)) {
+      first.pc = decoded_instruction{}.pc;
+      invalidated = true;
+    }
+    decoded_instruction &last = decoded_[decode_cache_index(last_address)];
+    if ((last.pc >> 2) == (last_address >> 2)) {
+      last.pc = decoded_instruction{}.pc;
+      invalidated = true;
+    }
+    return invalidated;
+  }
+
+#ifdef RV32I_THREADED
+  //
+  // threaded code
+  //  superblocks of decoded instructions that follow 'jal' and end with a
+  //  branch, 'jalr' or illegal instruction followed by an end of block entry
+  //  that continues at the next address
+  //
+
+  static auto constexpr block_index(uint32_t const address) -> uint32_t {
+    return (address >> 2) & ((1u << BLOCK_INDEX_BITWIDTH) - 1);
+  }
+
+  static auto constexpr ends_block(operation const op) -> bool {
+    using enum operation;
+    switch (op) {
+    case JALR:
+    case BEQ:
+    case BNE:
+    case BLT:
+    case BGE:
+    case BLTU:
+    case BGEU:
+    case ILLEGAL:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // translates the superblock starting at 'pc'
+  //  sets 'offset' to index of first instruction in 'threaded_' and 'count'
+  //  to number of instructions excluding the end of block entry
+  //  note: 'handler' is assigned by caller
+  auto translate(uint32_t const pc, uint32_t &offset, uint32_t &count)
+      -> status {
+    decoded_instruction block_instructions[BLOCK_MAX_INSTRUCTIONS];
+    bool evicted = false;
+    uint32_t address = pc;
+    count = 0;
+    while (count < BLOCK_MAX_INSTRUCTIONS) {
+      decoded_instruction &d = decoded_[decode_cache_index(address)];
+      if (d.pc != address) {
+        uint32_t instruction = 0;
+        if (bus_status const s = fetch(address, instruction)) {
+          if (count == 0) {
+            return 1000 + s;
+          }
+          // block ends before the instruction that cannot be fetched
+          break;
+        }
+        if (d.pc != decoded_instruction{}.pc) {
+          if (in_block(block_instructions, count, d.pc)) {
+            // the copy in this block would not be tracked by 'decoded_'
+            // thus block ends before the aliasing instruction
+            break;
+          }
+          // a store to the evicted instruction would not be detected
+          evicted = true;
+        }
+        d = decode(address, instruction);
+      }
+      block_instructions[count] = d;
+      ++count;
+      if (d.op == operation::JAL) {
+        // continue translating at the known target
+        address = uint32_t(int32_t(address) + d.imm);
+        continue;
+      }
+      address += 4;
+      if (ends_block(d.op)) {
+        break;
+      }
+    }
+
+    if (evicted || threaded_size_ + count + 1 > threaded_.size()) {
+      flush_threaded();
+    }
 
+    offset = threaded_size_;
+    for (uint32_t i = 0; i < count; ++i) {
+      threaded_instruction &ti = threaded_[offset + i];
+      ti = {};
+      ti.d = block_instructions[i];
+      if (ti.d.rd == 0) {
+        // write to sink instead of x0
+        ti.d.rd = 32;
+      }
+    }
+    threaded_[offset + count] = {};
+    threaded_[offset + count].d.pc = address;
+    threaded_size_ += count + 1;
+    blocks_[block_index(pc)] = {pc, offset};
     return 0;
   }
 
-  auto reg(uint32_t const num) const -> int32_t { return regs_[num]; }
-  auto pc() const -> uint32_t { return pc_; }
+  static auto constexpr in_block(decoded_instruction const *instructions,
+                                 uint32_t const count, uint32_t const pc)
+      -> bool {
+    for (uint32_t i = 0; i < count; ++i) {
+      if (instructions[i].pc == pc) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  auto flush_threaded() -> void {
+    threaded_size_ = 0;
+    for (block &b : blocks_) {
+      b.pc = block{}.pc;
+    }
+  }
+#endif
+
+  static auto constexpr decode(uint32_t const pc, uint32_t const instruction)
+      -> decoded_instruction {
+    using enum operation;
+    decoded_instruction d{};
+    d.pc = pc;
+    d.rd = uint8_t(RD_from(instruction));
+    d.rs1 = uint8_t(RS1_from(instruction));
+    d.rs2 = uint8_t(RS2_from(instruction));
+#ifdef RV32I_DEBUG
+    d.instruction = instruction;
+#endif
+    auto const illegal = [&d](int32_t const status) -> decoded_instruction {
+      d.op = ILLEGAL;
+      d.imm = status;
+      return d;
+    };
+    uint32_t const funct3 = FUNCT3_from(instruction);
+    uint32_t const funct7 = FUNCT7_from(instruction);
+    switch (OPCODE_from(instruction)) {
+    case OPCODE_LUI:
+      d.op = LUI;
+      d.imm = int32_t(U_imm20_from(instruction));
+      return d;
+    case OPCODE_AUIPC:
+      d.op = AUIPC;
+      d.imm = int32_t(U_imm20_from(instruction));
+      return d;
+    case OPCODE_JAL:
+      d.op = JAL;
+      d.imm = J_imm20_from(instruction);
+      return d;
+    case OPCODE_JALR:
+      d.op = JALR;
+      d.imm = I_imm12_from(instruction);
+      return d;
+    case OPCODE_LOGICAL_IMM:
+      d.imm = I_imm12_from(instruction);
+      switch (funct3) {
+      case FUNCT3_ADDI:
+        d.op = ADDI;
+        return d;
+      case FUNCT3_SLTI:
+        d.op = SLTI;
+        return d;
+      case FUNCT3_SLTIU:
+        d.op = SLTIU;
+        return d;
+      case FUNCT3_XORI:
+        d.op = XORI;
+        return d;
+      case FUNCT3_ORI:
+        d.op = ORI;
+        return d;
+      case FUNCT3_ANDI:
+        d.op = ANDI;
+        return d;
+      case FUNCT3_SLLI:
+        d.op = SLLI;
+        d.imm = int32_t(RS2_from(instruction));
+        return d;
+      case FUNCT3_SRLI_SRAI:
+        d.imm = int32_t(RS2_from(instruction));
+        switch (funct7) {
+        case FUNCT7_SRLI:
+          d.op = SRLI;
+          return d;
+        case FUNCT7_SRAI:
+          d.op = SRAI;
+          return d;
+        default:
+          return illegal(1);
+        }
+      default:
+        return illegal(2);
+      }
+    case OPCODE_LOGICAL:
+      switch (funct3) {
+      case FUNCT3_ADD_SUB:
+        switch (funct7) {
+        case FUNCT7_ADD:
+          d.op = ADD;
+          return d;
+        case FUNCT7_SUB:
+          d.op = SUB;
+          return d;
+        default:
+          return illegal(3);
+        }
+      case FUNCT3_SLL:
+        d.op = SLL;
+        return d;
+      case FUNCT3_SLT:
+        d.op = SLT;
+        return d;
+      case FUNCT3_SLTU:
+        d.op = SLTU;
+        return d;
+      case FUNCT3_XOR:
+        d.op = XOR;
+        return d;
+      case FUNCT3_SRL_SRA:
+        switch (funct7) {
+        case FUNCT7_SRL:
+          d.op = SRL;
+          return d;
+        case FUNCT7_SRA:
+          d.op = SRA;
+          return d;
+        default:
+          return illegal(4);
+        }
+      case FUNCT3_OR:
+        d.op = OR;
+        return d;
+      case FUNCT3_AND:
+        d.op = AND;
+        return d;
+      default:
+        return illegal(5);
+      }
+    case OPCODE_STORE:
+      d.imm = S_imm12_from(instruction);
+      switch (funct3) {
+      case FUNCT3_SB:
+        d.op = SB;
+        return d;
+      case FUNCT3_SH:
+        d.op = SH;
+        return d;
+      case FUNCT3_SW:
+        d.op = SW;
+        return d;
+      default:
+        return illegal(6);
+      }
+    case OPCODE_LOAD:
+      d.imm = I_imm12_from(instruction);
+      switch (funct3) {
+      case FUNCT3_LB:
+        d.op = LB;
+        return d;
+      case FUNCT3_LH:
+        d.op = LH;
+        return d;
+      case FUNCT3_LW:
+        d.op = LW;
+        return d;
+      case FUNCT3_LBU:
+        d.op = LBU;
+        return d;
+      case FUNCT3_LHU:
+        d.op = LHU;
+        return d;
+      default:
+        return illegal(7);
+      }
+    case OPCODE_BRANCH:
+      d.imm = B_imm12_from(instruction);
+      switch (funct3) {
+      case FUNCT3_BEQ:
+        d.op = BEQ;
+        return d;
+      case FUNCT3_BNE:
+        d.op = BNE;
+        return d;
+      case FUNCT3_BLT:
+        d.op = BLT;
+        return d;
+      case FUNCT3_BGE:
+        d.op = BGE;
+        return d;
+      case FUNCT3_BLTU:
+        d.op = BLTU;
+        return d;
+      case FUNCT3_BGEU:
+        d.op = BGEU;
+        return d;
+      default:
+        return illegal(8);
+      }
+    default:
+      return illegal(9);
+    }
+  }
 
-private:
   //
   // instruction decoding
   //  see: /notes/riscv-docs/rv32i-base-instruction-set.png
@@ -648,4 +1636,10 @@ private:
   static uint32_t constexpr FUNCT3_BGEU = 0b111;
 };
 
+// note: a 'bus' callback is adapted by 'callback_bus'
+cpu(bus) -> cpu<callback_bus>;
+cpu(bus, uint32_t) -> cpu<callback_bus>;
+cpu(bus, uint8_t *, uint32_t) -> cpu<callback_bus>;
+cpu(bus, uint8_t *, uint32_t, uint32_t) -> cpu<callback_bus>;
+
 } // namespace rv32i
@@ -0,0 +1,121 @@
+//
+// snapshot of machine state
+//
+#pragma once
+
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <unistd.h>
+#include <vector>
+
+// file: header, one byte per RAM page that is 1 when the page is in the image,
+// image of those RAM pages at 'ram_offset' (page aligned) followed by the SD
+// card sectors written since start as 4 B sector number and 512 B data
+//  note: RAM image is mapped copy-on-write when restored
+struct snapshot_header final {
+  static size_t constexpr SECTOR_SIZE = 512;
+
+  char magic[8]{'O', 'S', 'Q', 'A', 'S', 'N', 'P', '2'};
+  uint32_t pc{};
+  int32_t regs[32]{};
+  uint32_t sector_buffer_index{};
+  uint8_t sector_buffer[SECTOR_SIZE]{};
+  uint64_t ram_offset{};
+  uint64_t ram_size{};
+  uint64_t ram_page_size{};
+  uint64_t ram_page_count{};
+  uint64_t sdcard_sector_count{};
+};
+
+// writes snapshot of 'header' state, 'ram' and the 'sdcard' sectors in
+// 'sdcard_sectors' to 'file_name'
+//  note: only RAM pages holding data are written; the others are filled
+//        again when first accessed after restore
+inline auto write_snapshot(char const *file_name, snapshot_header header,
+                           mapped_file const &ram, uint8_t const *sdcard,
+                           std::set<uint32_t> const &sdcard_sectors) -> bool {
+  FILE *const f = fopen(file_name, "wb");
+  if (!f) {
+    printf("Snapshot: error opening file '%s'\n", file_name);
+    return false;
+  }
+
+  size_t const page_size = size_t(sysconf(_SC_PAGESIZE));
+  std::vector<uint8_t> pages((ram.size() + page_size - 1) / page_size);
+  header.ram_page_count = 0;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    pages[i] = ram.is_page_present(i * page_size) ? 1 : 0;
+    header.ram_page_count += pages[i];
+  }
+  header.ram_offset =
+      (sizeof(header) + pages.size() + page_size - 1) / page_size * page_size;
+  header.ram_size = ram.size();
+  header.ram_page_size = page_size;
+  header.sdcard_sector_count = sdcard_sectors.size();
+
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(pages.data(), pages.size(), 1, f) == 1 &&
+            fseeko(f, off_t(header.ram_offset), SEEK_SET) == 0;
+  for (size_t i = 0; ok && i < pages.size(); ++i) {
+    if (pages[i]) {
+      ok = fwrite(ram.data() + i * page_size, page_size, 1, f) == 1;
+    }
+  }
+  for (uint32_t const sector : sdcard_sectors) {
+    ok = ok && fwrite(&sector, sizeof(sector), 1, f) == 1 &&
+         fwrite(sdcard + size_t(sector) * snapshot_header::SECTOR_SIZE,
+                snapshot_header::SECTOR_SIZE, 1, f) == 1;
+  }
+  ok = fclose(f) == 0 && ok;
+  if (!ok) {
+    printf("Snapshot: error writing file '%s'\n", file_name);
+  }
+  return ok;
+}
+
+// reads header and RAM page map of snapshot 'file_name' and copies the SD card
+// sectors into 'sdcard' of 'sdcard_size' bytes
+//  note: RAM is mapped by the caller using 'header.ram_offset' and 'ram_pages'
+inline auto read_snapshot(char const *file_name, snapshot_header &header,
+                          std::vector<uint8_t> &ram_pages, uint8_t *sdcard,
+                          size_t const sdcard_size,
+                          std::set<uint32_t> &sdcard_sectors) -> bool {
+  FILE *const f = fopen(file_name, "rb");
+  if (!f) {
+    printf("Snapshot: error opening file '%s'\n", file_name);
+    return false;
+  }
+
+  bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+            !memcmp(header.magic, snapshot_header{}.magic,
+                    sizeof(header.magic)) &&
+            header.ram_page_size == uint64_t(sysconf(_SC_PAGESIZE));
+  if (ok) {
+    ram_pages.resize((header.ram_size + header.ram_page_size - 1) /
+                     header.ram_page_size);
+    ok = fread(ram_pages.data(), ram_pages.size(), 1, f) == 1 &&
+         fseeko(f,
+                off_t(header.ram_offset +
+                      header.ram_page_count * header.ram_page_size),
+                SEEK_SET) == 0;
+  }
+  for (uint64_t i = 0; ok && i < header.sdcard_sector_count; ++i) {
+    uint32_t sector = 0;
+    ok = fread(&sector, sizeof(sector), 1, f) == 1 &&
+         (size_t(sector) + 1) * snapshot_header::SECTOR_SIZE <= sdcard_size &&
+         fread(sdcard + size_t(sector) * snapshot_header::SECTOR_SIZE,
+               snapshot_header::SECTOR_SIZE, 1, f) == 1;
+    if (ok) {
+      sdcard_sectors.insert(sector);
+    }
+  }
+  fclose(f);
+  if (!ok) {
+    printf("Snapshot: error reading file '%s'\n", file_name);
+  }
+  return ok;
+}
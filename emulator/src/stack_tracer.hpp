@@ -0,0 +1,90 @@
+//
+// stack usage and call depth of firmware
+//
+#pragma once
+
+#include "listing.hpp"
+#include "rv32i.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// tracks the minimum stack pointer and the calls made with 'jal'/'jalr' that
+// link to 'ra' and return with 'jalr' through 'ra'
+//  note: tracking starts when 'sp' is set to the top of the stack
+class stack_tracer final {
+  static uint32_t constexpr SP = 2;
+  static uint32_t constexpr RA = 1;
+
+  uint32_t stack_top_{};
+  bool started_{};
+  uint32_t min_sp_{};
+  uint32_t min_sp_pc_{};
+  std::vector<uint32_t> calls_;         // called addresses
+  std::vector<uint32_t> calls_min_sp_;  // calls when 'min_sp_' was reached
+  std::vector<uint32_t> calls_deepest_; // deepest calls
+
+public:
+  explicit stack_tracer(uint32_t const stack_top)
+      : stack_top_{stack_top}, min_sp_{stack_top} {}
+
+  auto execute(rv32i::decoded_instruction const &d, int32_t const *regs)
+      -> void {
+    uint32_t const sp = uint32_t(regs[SP]);
+    if (!started_) {
+      if (sp != stack_top_) {
+        return;
+      }
+      started_ = true;
+    }
+
+    if (sp < min_sp_) {
+      min_sp_ = sp;
+      min_sp_pc_ = d.pc;
+      calls_min_sp_ = calls_;
+    }
+
+    if (d.op == rv32i::operation::JAL && d.rd == RA) {
+      call(d.pc + uint32_t(d.imm));
+    } else if (d.op == rv32i::operation::JALR) {
+      if (d.rd == RA) {
+        call(uint32_t(regs[d.rs1] + d.imm) & ~1u);
+      } else if (d.rs1 == RA && !calls_.empty()) {
+        calls_.pop_back();
+      }
+    }
+  }
+
+  auto print_report(FILE *const f, listing const &lst) const -> void {
+    fprintf(f, "stack: top 0x%08x, minimum sp 0x%08x, peak usage %u B\n",
+            stack_top_, min_sp_, stack_top_ - min_sp_);
+    if (min_sp_ != stack_top_) {
+      fprintf(f, "  at 0x%08x in %s with calls:\n", min_sp_pc_,
+              name(lst, min_sp_pc_));
+      print_calls(f, lst, calls_min_sp_);
+    }
+    fprintf(f, "calls: maximum depth %zu:\n", calls_deepest_.size());
+    print_calls(f, lst, calls_deepest_);
+  }
+
+private:
+  auto call(uint32_t const address) -> void {
+    calls_.push_back(address);
+    if (calls_.size() > calls_deepest_.size()) {
+      calls_deepest_ = calls_;
+    }
+  }
+
+  static auto print_calls(FILE *const f, listing const &lst,
+                          std::vector<uint32_t> const &calls) -> void {
+    for (size_t i = calls.size(); i-- > 0;) {
+      fprintf(f, "    0x%08x %s\n", calls[i], name(lst, calls[i]));
+    }
+  }
+
+  static auto name(listing const &lst, uint32_t const address)
+      -> char const * {
+    char const *const s = lst.symbol_at(address);
+    return s ? s : "?";
+  }
+};
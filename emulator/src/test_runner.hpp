@@ -0,0 +1,245 @@
+//
+// runs tests in forked copies of a booted machine
+//
+#pragma once
+
+#include "rv32i.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+// boots the firmware once and forks a child per test that runs the input in
+// '<name>.in' and compares output with '<name>.diff'
+//  input is decoded as by 'echo -e' like 'os/qa-emulator/test.sh' does
+//  child ends when firmware waits for input after all input has been read
+//  output of failed test is written to '<name>.out'
+//  note: RAM and SD card are private mappings thus children run on
+//        copy-on-write pages of the booted machine
+class test_runner final {
+  // seconds a test may run
+  static unsigned constexpr TIMEOUT_S = 60;
+
+public:
+  // true when firmware is idle waiting for input after 'run_result'
+  using idle_check = auto (*)(rv32i::run_result const &) -> bool;
+
+private:
+  idle_check is_idle_{};
+
+public:
+  explicit test_runner(idle_check const is_idle) : is_idle_{is_idle} {}
+
+  // returns 0 if all tests passed
+  template <typename cpu_type>
+  auto run(cpu_type &cpu, std::span<char const *const> const tests) const
+      -> int {
+    // boot with output to a memory file and no input
+    fflush(stdout);
+    int const saved_stdout = dup(STDOUT_FILENO);
+    redirect(STDIN_FILENO, open("/dev/null", O_RDONLY));
+    redirect(STDOUT_FILENO, memfd_create("boot-output", 0));
+    bool const booted = run_until_input_consumed(cpu);
+    fflush(stdout);
+    std::string const boot = read_all(STDOUT_FILENO);
+    redirect(STDOUT_FILENO, saved_stdout);
+    if (!booted) {
+      fprintf(stderr, "test: firmware failed during boot\n%s", boot.c_str());
+      return 1;
+    }
+
+    unsigned const max_children =
+        std::max(1u, std::thread::hardware_concurrency());
+    size_t next = 0;
+    unsigned running = 0;
+    unsigned failed = 0;
+    pid_t pids[256]{};
+    size_t pid_test[256]{};
+    while (next < tests.size() || running) {
+      if (next < tests.size() && running < max_children &&
+          running < std::size(pids)) {
+        pid_t const pid = fork();
+        if (pid == 0) {
+          _exit(run_child(cpu, tests[next], boot));
+        }
+        for (size_t i = 0; i < std::size(pids); ++i) {
+          if (!pids[i]) {
+            pids[i] = pid;
+            pid_test[i] = next;
+            break;
+          }
+        }
+        ++next;
+        ++running;
+        continue;
+      }
+      int status = 0;
+      pid_t const pid = wait(&status);
+      if (pid == -1) {
+        break;
+      }
+      for (size_t i = 0; i < std::size(pids); ++i) {
+        if (pids[i] == pid) {
+          bool const passed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+          fprintf(stderr, "test %s: %s\n", tests[pid_test[i]],
+                  passed ? "PASSED" : "FAILED");
+          failed += passed ? 0 : 1;
+          pids[i] = 0;
+          --running;
+          break;
+        }
+      }
+    }
+    return failed ? 1 : 0;
+  }
+
+private:
+  // runs until firmware waits for input and no more input is available
+  template <typename cpu_type>
+  auto run_until_input_consumed(cpu_type &cpu) const -> bool {
+    while (true) {
+      rv32i::run_result const r = cpu.run(1'000'000);
+      if (r.reason == rv32i::stop_reason::ERROR) {
+        printf("CPU error: %d\n", r.error);
+        return false;
+      }
+      if (is_idle_(r) && feof(stdin)) {
+        return true;
+      }
+    }
+  }
+
+  // runs test in child and returns exit status
+  template <typename cpu_type>
+  auto run_child(cpu_type &cpu, char const *test, std::string const &boot)
+      const -> int {
+    alarm(TIMEOUT_S);
+    std::string_view const name = strip_suffix(test, ".in");
+
+    int const in = open(test, O_RDONLY);
+    if (in == -1) {
+      fprintf(stderr, "test %s: error opening file\n", test);
+      return 2;
+    }
+    std::string const input = echo_unescape(read_all(in));
+    close(in);
+    redirect(STDIN_FILENO, memfd_create("test-input", 0));
+    if (write(STDIN_FILENO, input.data(), input.size()) !=
+        ssize_t(input.size())) {
+      return 2;
+    }
+    lseek(STDIN_FILENO, 0, SEEK_SET);
+    clearerr(stdin);
+
+    redirect(STDOUT_FILENO, memfd_create("test-output", 0));
+    bool const ok = run_until_input_consumed(cpu);
+    fflush(stdout);
+    std::string const output = boot + read_all(STDOUT_FILENO);
+
+    std::string const expected_file = std::string{name} + ".diff";
+    int const expected = open(expected_file.c_str(), O_RDONLY);
+    if (expected == -1) {
+      fprintf(stderr, "test %s: error opening file '%s'\n", test,
+              expected_file.c_str());
+      return 2;
+    }
+    if (ok && read_all(expected) == output) {
+      return 0;
+    }
+    std::string const output_file_name = std::string{name} + ".out";
+    FILE *const f = fopen(output_file_name.c_str(), "wb");
+    if (f) {
+      fwrite(output.data(), 1, output.size(), f);
+      fclose(f);
+    }
+    return 1;
+  }
+
+  static auto redirect(int const to, int const from) -> void {
+    dup2(from, to);
+    close(from);
+  }
+
+  static auto read_all(int const fd) -> std::string {
+    std::string s;
+    lseek(fd, 0, SEEK_SET);
+    char buf[4096];
+    ssize_t n = 0;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+      s.append(buf, size_t(n));
+    }
+    return s;
+  }
+
+  static auto strip_suffix(std::string_view s, std::string_view const suffix)
+      -> std::string_view {
+    if (s.ends_with(suffix)) {
+      s.remove_suffix(suffix.size());
+    }
+    return s;
+  }
+
+  // decodes '\e', '\n', '\r', '\t', '\\' and '\xHH' as 'echo -e' does and
+  // removes the last newline as '$(cat file)' does before 'echo' adds one
+  static auto echo_unescape(std::string_view s) -> std::string {
+    while (s.ends_with('\n')) {
+      s.remove_suffix(1);
+    }
+    std::string out;
+    for (size_t i = 0; i < s.size(); ++i) {
+      if (s[i] != '\\' || i + 1 == s.size()) {
+        out += s[i];
+        continue;
+      }
+      char const c = s[++i];
+      switch (c) {
+      case 'e':
+        out += '\x1b';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case '\\':
+        out += '\\';
+        break;
+      case 'x': {
+        unsigned v = 0;
+        size_t n = 0;
+        while (n < 2 && i + 1 < s.size() &&
+               isxdigit(static_cast<unsigned char>(s[i + 1]))) {
+          char const h = s[++i];
+          v = v * 16 + unsigned(h <= '9' ? h - '0' : (h | 0x20) - 'a' + 10);
+          ++n;
+        }
+        if (n == 0) {
+          // no hex digits; kept as written
+          out += "\\x";
+          break;
+        }
+        out += char(v);
+        break;
+      }
+      default:
+        out += '\\';
+        out += c;
+        break;
+      }
+    }
+    out += '\n';
+    return out;
+  }
+};
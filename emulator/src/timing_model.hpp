@@ -0,0 +1,108 @@
+//
+// cycle approximate timing of 'core.sv' with 'cache.sv'
+//
+#pragma once
+
+#include "cache_model.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+// estimates cycles of executed instructions from the states of 'core.sv' and
+// the cache misses of 'cache.sv'
+//  instruction: 'CpuFetch' + 'CpuExecute'
+//   load/store: + 'CpuLoad' / 'CpuStore'
+//        I/O: accessed without cache in 1 cycle
+//  note: waits for I/O such as UART transmit are not modeled
+class timing_model final {
+  // cycles from a RAM command until the next can be issued
+  //  'cache.sv' 'CommandDelayIntervalCycles' + 1 to count down
+  static uint64_t constexpr COMMAND_INTERVAL_CYCLES = 14;
+
+  // cycles from read command to first data
+  //  as 'burst_ram' in simulations
+  static uint64_t constexpr READ_LATENCY_CYCLES = 6;
+
+  // bytes transferred per cycle of a burst
+  static uint64_t constexpr BURST_BYTES_PER_CYCLE = 8;
+
+  cache_model cache_;
+  uint64_t burst_cycles_{};
+  uint32_t io_addresses_start_{};
+  uint32_t frequency_hz_{};
+  uint64_t cycle_{};
+  uint64_t command_ready_cycle_{}; // when next RAM command can be issued
+  uint64_t instructions_{};
+
+public:
+  timing_model(cache_model const &cache, uint32_t const io_addresses_start,
+               uint32_t const frequency_hz)
+      : cache_{cache},
+        burst_cycles_{cache.line_size_bytes() / BURST_BYTES_PER_CYCLE},
+        io_addresses_start_{io_addresses_start}, frequency_hz_{frequency_hz} {}
+
+  // instruction at 'pc' fetched and executed
+  auto execute(uint32_t const pc) -> void {
+    ++instructions_;
+    access(pc, cache_model::access_type::FETCH);
+    ++cycle_; // 'CpuExecute'
+  }
+
+  auto load(uint32_t const address) -> void {
+    access(address, cache_model::access_type::LOAD);
+  }
+
+  auto store(uint32_t const address) -> void {
+    // 'cache.sv' is busy until command interval has passed
+    cycle_ = std::max(cycle_, command_ready_cycle_);
+    access(address, cache_model::access_type::STORE);
+  }
+
+  auto cache() const -> cache_model const & { return cache_; }
+
+  auto cycles() const -> uint64_t { return cycle_; }
+
+  auto instructions() const -> uint64_t { return instructions_; }
+
+  auto seconds() const -> double { return double(cycle_) / frequency_hz_; }
+
+  auto print_report(FILE *const f) const -> void {
+    fprintf(f, "timing: %u B cache, %u B lines, %u way, %s, %u Hz\n",
+            cache_.size_bytes(), cache_.line_size_bytes(), cache_.ways(),
+            cache_.policy() == cache_model::write_policy::WRITE_BACK
+                ? "write-back"
+                : "write-through",
+            frequency_hz_);
+    fprintf(f, "  instructions: %llu\n", (unsigned long long)(instructions_));
+    fprintf(f, "        cycles: %llu\n", (unsigned long long)(cycle_));
+    fprintf(f, "           CPI: %.3f\n",
+            instructions_ ? double(cycle_) / double(instructions_) : 0.0);
+    fprintf(f, "          time: %.6f s\n", seconds());
+  }
+
+private:
+  // one cycle in the state accessing 'address' plus cycles of a miss
+  auto access(uint32_t const address, cache_model::access_type const type)
+      -> void {
+    if (address >= io_addresses_start_) {
+      ++cycle_;
+      return;
+    }
+    cache_model::result const r = cache_.access(address, type);
+    if (type == cache_model::access_type::STORE &&
+        cache_.policy() == cache_model::write_policy::WRITE_THROUGH) {
+      // write command is issued without waiting for it to complete
+      command_ready_cycle_ = cycle_ + COMMAND_INTERVAL_CYCLES;
+    } else if (r != cache_model::result::HIT) {
+      uint64_t command = std::max(cycle_, command_ready_cycle_);
+      if (r == cache_model::result::MISS_DIRTY_EVICTION) {
+        // write line then wait for command interval
+        command += COMMAND_INTERVAL_CYCLES;
+      }
+      command_ready_cycle_ = command + COMMAND_INTERVAL_CYCLES;
+      // command, data, 'ReadFinish'
+      cycle_ = command + 1 + READ_LATENCY_CYCLES + burst_cycles_ + 1;
+    }
+    ++cycle_;
+  }
+};
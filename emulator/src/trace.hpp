@@ -0,0 +1,308 @@
+//
+// binary trace of executed instructions
+//
+// note: shared by emulator and trace tool
+//
+#pragma once
+
+#include "rv32i.hpp"
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// file: "RV32ITR1" followed by records
+// record: flags byte followed by the fields the flags select
+//   bit 0: pc is not previous pc + 4
+//          zigzag varint of pc - (previous pc + 4)
+//   bit 1: register written
+//          byte register number, varint value
+//   bit 2-3: memory access: 0 none, 1 load, 2 store
+//   bit 4-5: width: 0 byte, 1 half word, 2 word
+//          zigzag varint of address - previous memory address,
+//          varint value
+// varint: 7 bits per byte starting with least significant, bit 7 set when
+//         more bytes follow
+
+static char constexpr TRACE_MAGIC[8]{'R', 'V', '3', '2', 'I', 'T', 'R', '1'};
+
+struct trace_record final {
+  enum class memory_access : uint8_t { NONE, LOAD, STORE };
+
+  uint32_t pc{};
+  uint8_t rd{}; // 0 if no register written
+  uint32_t rd_value{};
+  memory_access access{memory_access::NONE};
+  uint8_t width{}; // 1, 2 or 4 bytes
+  uint32_t address{};
+  uint32_t value{};
+
+  auto operator==(trace_record const &) const -> bool = default;
+};
+
+// encodes records relative to the previous one
+class trace_encoder final {
+  uint32_t pc_{};
+  uint32_t address_{};
+
+public:
+  static size_t constexpr MAX_RECORD_SIZE = 1 + 5 + 1 + 5 + 5 + 5;
+
+  // encodes 'r' into 'out' with room for 'MAX_RECORD_SIZE' bytes
+  //  returns number of bytes written
+  auto encode(trace_record const &r, uint8_t *const out) -> size_t {
+    uint8_t *p = out + 1;
+    uint8_t flags = 0;
+    if (r.pc != pc_ + 4) {
+      flags |= 1;
+      p = put(p, zigzag(r.pc - (pc_ + 4)));
+    }
+    pc_ = r.pc;
+    if (r.rd) {
+      flags |= 2;
+      *p++ = r.rd;
+      p = put(p, r.rd_value);
+    }
+    if (r.access != trace_record::memory_access::NONE) {
+      flags |= uint8_t(uint32_t(r.access) << 2);
+      flags |= uint8_t((r.width == 1 ? 0 : r.width == 2 ? 1 : 2) << 4);
+      p = put(p, zigzag(r.address - address_));
+      p = put(p, r.value);
+      address_ = r.address;
+    }
+    *out = flags;
+    return size_t(p - out);
+  }
+
+private:
+  static auto zigzag(uint32_t const delta) -> uint32_t {
+    return (delta << 1) ^ uint32_t(int32_t(delta) >> 31);
+  }
+
+  static auto put(uint8_t *p, uint32_t v) -> uint8_t * {
+    while (v >= 0x80) {
+      *p++ = uint8_t(v | 0x80);
+      v >>= 7;
+    }
+    *p++ = uint8_t(v);
+    return p;
+  }
+};
+
+// reads records from a trace file
+class trace_reader final {
+  FILE *file_{};
+  uint32_t pc_{};
+  uint32_t address_{};
+
+public:
+  trace_reader() = default;
+  trace_reader(trace_reader const &) = delete;
+  auto operator=(trace_reader const &) -> trace_reader & = delete;
+
+  ~trace_reader() {
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  auto open(char const *file_name) -> bool {
+    file_ = fopen(file_name, "rb");
+    if (!file_) {
+      return false;
+    }
+    char magic[sizeof(TRACE_MAGIC)]{};
+    return fread(magic, 1, sizeof(magic), file_) == sizeof(magic) &&
+           !memcmp(magic, TRACE_MAGIC, sizeof(magic));
+  }
+
+  // reads next record into 'r' and returns false at end of file or error
+  auto read(trace_record &r) -> bool {
+    int const flags = getc(file_);
+    if (flags == EOF) {
+      return false;
+    }
+    r = {};
+    uint32_t v = 0;
+    if (flags & 1) {
+      if (!get(v)) {
+        return false;
+      }
+      r.pc = pc_ + 4 + unzigzag(v);
+    } else {
+      r.pc = pc_ + 4;
+    }
+    pc_ = r.pc;
+    if (flags & 2) {
+      int const rd = getc(file_);
+      if (rd == EOF || !get(r.rd_value)) {
+        return false;
+      }
+      r.rd = uint8_t(rd);
+    }
+    r.access = trace_record::memory_access((flags >> 2) & 3);
+    if (r.access != trace_record::memory_access::NONE) {
+      r.width = uint8_t(1u << ((flags >> 4) & 3));
+      if (!get(v) || !get(r.value)) {
+        return false;
+      }
+      r.address = address_ + unzigzag(v);
+      address_ = r.address;
+    }
+    return true;
+  }
+
+private:
+  static auto unzigzag(uint32_t const v) -> uint32_t {
+    return (v >> 1) ^ (0 - (v & 1));
+  }
+
+  auto get(uint32_t &v) -> bool {
+    v = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+      int const c = getc(file_);
+      if (c == EOF) {
+        return false;
+      }
+      v |= uint32_t(c & 0x7f) << shift;
+      if (!(c & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// encodes records into buffers written to file by a background thread
+//  note: 2 buffers; one is filled while the writer thread writes the other
+class trace_writer final {
+  static size_t constexpr BUFFER_SIZE = 1024 * 1024;
+
+  FILE *file_{};
+  trace_encoder encoder_;
+  std::vector<uint8_t> buffers_[2];
+  size_t sizes_[2]{}; // bytes in buffer; 0 ends writer thread
+  size_t filling_{};  // index of buffer being filled
+  std::barrier<> barrier_{2};
+  std::thread writer_;
+
+public:
+  trace_writer() = default;
+  trace_writer(trace_writer const &) = delete;
+  auto operator=(trace_writer const &) -> trace_writer & = delete;
+
+  ~trace_writer() { close(); }
+
+  auto open(char const *file_name) -> bool {
+    file_ = fopen(file_name, "wb");
+    if (!file_) {
+      return false;
+    }
+    fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), file_);
+    for (std::vector<uint8_t> &b : buffers_) {
+      b.resize(BUFFER_SIZE);
+    }
+    writer_ = std::thread{[this] { work(); }};
+    return true;
+  }
+
+  auto write(trace_record const &r) -> void {
+    size_t &n = sizes_[filling_];
+    n += encoder_.encode(r, buffers_[filling_].data() + n);
+    if (n > BUFFER_SIZE - trace_encoder::MAX_RECORD_SIZE) {
+      publish();
+    }
+  }
+
+  // writes buffered records and closes file
+  auto close() -> void {
+    if (!file_) {
+      return;
+    }
+    if (sizes_[filling_]) {
+      publish();
+    }
+    publish(); // empty buffer ends the writer thread
+    writer_.join();
+    fclose(file_);
+    file_ = nullptr;
+  }
+
+private:
+  // hands the filled buffer to the writer thread when it is done with the
+  // other
+  auto publish() -> void {
+    barrier_.arrive_and_wait();
+    filling_ ^= 1;
+    sizes_[filling_] = 0;
+  }
+
+  auto work() -> void {
+    for (size_t buffer = 0;; buffer ^= 1) {
+      barrier_.arrive_and_wait();
+      size_t const n = sizes_[buffer];
+      if (!n) {
+        return;
+      }
+      fwrite(buffers_[buffer].data(), 1, n, file_);
+    }
+  }
+};
+
+// makes records of retired instructions from observed execution and writes
+// them to 'sink_type' such as 'trace_writer'
+//  note: the record of an instruction is written when the next executes and
+//        the written register value is known
+template <typename sink_type> class execution_tracer final {
+  sink_type &sink_;
+  trace_record record_;
+  bool pending_{};
+
+public:
+  explicit execution_tracer(sink_type &sink) : sink_{sink} {}
+
+  auto execute(rv32i::decoded_instruction const &d, int32_t const *regs)
+      -> void {
+    complete(regs);
+    using enum rv32i::operation;
+    bool const writes_rd = !(d.op >= BEQ && d.op <= BGEU) &&
+                           !(d.op >= SB && d.op <= SW) && d.op != ILLEGAL &&
+                           d.rd != 0 && d.rd != 32;
+    record_ = {.pc = d.pc, .rd = writes_rd ? d.rd : uint8_t(0)};
+    pending_ = true;
+  }
+
+  auto load(uint32_t const address, rv32i::bus_op_width const op_width,
+            uint32_t const data) -> void {
+    access(trace_record::memory_access::LOAD, address, op_width, data);
+  }
+
+  auto store(uint32_t const address, rv32i::bus_op_width const op_width,
+             uint32_t const data) -> void {
+    access(trace_record::memory_access::STORE, address, op_width, data);
+  }
+
+  // writes the record of the last instruction given the registers x0..x31
+  // after it executed
+  auto complete(int32_t const *regs) -> void {
+    if (!pending_) {
+      return;
+    }
+    record_.rd_value = uint32_t(regs[record_.rd]);
+    sink_.write(record_);
+    pending_ = false;
+  }
+
+private:
+  auto access(trace_record::memory_access const type, uint32_t const address,
+              rv32i::bus_op_width const op_width, uint32_t const data)
+      -> void {
+    record_.access = type;
+    record_.width = uint8_t(op_width);
+    record_.address = address;
+    record_.value = data;
+  }
+};
@@ -0,0 +1,104 @@
+//
+// prints and compares binary traces made by 'osqa --trace'
+//
+#include "trace.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+using namespace std;
+
+static auto print_record(uint64_t const index, trace_record const &r)
+    -> void {
+  printf("%12llu  pc 0x%08x", (unsigned long long)(index), r.pc);
+  if (r.rd) {
+    printf("  x%-2u = 0x%08x", r.rd, r.rd_value);
+  }
+  if (r.access != trace_record::memory_access::NONE) {
+    printf("  %s%u [0x%08x] 0x%08x",
+           r.access == trace_record::memory_access::LOAD ? "load" : "store",
+           r.width, r.address, r.value);
+  }
+  printf("\n");
+}
+
+// prints 'count' records starting at record 'first'
+static auto print(char const *file_name, uint64_t const first,
+                  uint64_t const count) -> int {
+  trace_reader reader;
+  if (!reader.open(file_name)) {
+    printf("Trace: error opening file '%s'\n", file_name);
+    return 2;
+  }
+  trace_record r;
+  for (uint64_t i = 0; i < first + count && reader.read(r); ++i) {
+    if (i >= first) {
+      print_record(i, r);
+    }
+  }
+  return 0;
+}
+
+// compares traces and prints the first difference
+//  returns 0 if identical, 1 if different
+static auto diff(char const *file_name_a, char const *file_name_b) -> int {
+  trace_reader a;
+  trace_reader b;
+  if (!a.open(file_name_a)) {
+    printf("Trace: error opening file '%s'\n", file_name_a);
+    return 2;
+  }
+  if (!b.open(file_name_b)) {
+    printf("Trace: error opening file '%s'\n", file_name_b);
+    return 2;
+  }
+  trace_record ra;
+  trace_record rb;
+  for (uint64_t i = 0;; ++i) {
+    bool const has_a = a.read(ra);
+    bool const has_b = b.read(rb);
+    if (!has_a && !has_b) {
+      printf("identical: %llu records\n", (unsigned long long)(i));
+      return 0;
+    }
+    if (has_a != has_b) {
+      printf("%s ends at record %llu\n", has_a ? file_name_b : file_name_a,
+             (unsigned long long)(i));
+      print_record(i, has_a ? ra : rb);
+      return 1;
+    }
+    if (ra != rb) {
+      printf("differ at record %llu:\n", (unsigned long long)(i));
+      printf("%s:\n", file_name_a);
+      print_record(i, ra);
+      printf("%s:\n", file_name_b);
+      print_record(i, rb);
+      return 1;
+    }
+  }
+}
+
+static auto print_usage(char const *program) -> void {
+  printf("Usage: %s print <trace> [first] [count]\n", program);
+  printf("       %s diff <trace a> <trace b>\n", program);
+}
+
+auto main(int argc, char **argv) -> int {
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  string_view const command = argv[1];
+  if (command == "print" && argc <= 5) {
+    uint64_t const first = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+    uint64_t const count =
+        argc > 4 ? strtoull(argv[4], nullptr, 10) : UINT64_MAX - first;
+    return print(argv[2], first, count);
+  }
+  if (command == "diff" && argc == 4) {
+    return diff(argv[2], argv[3]);
+  }
+  print_usage(argv[0]);
+  return 1;
+}
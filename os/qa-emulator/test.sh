@@ -10,7 +10,7 @@ FIRMWARE=../os.bin
 SDCARD=../../notes/samples/sample.txt
 
 echo " * running test for 5 seconds"
-echo -e "$(cat test.in)" | timeout 5 $EMULATOR $FIRMWARE $SDCARD > test.out || true
+echo -e "$(cat test.in)" | timeout 5 $EMULATOR --throughput $FIRMWARE $SDCARD > test.out || true
 
 if cmp -s test.diff test.out; then
     echo "test: PASSED"
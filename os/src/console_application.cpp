@@ -4,13 +4,16 @@
 // note: meant to be run in Visual Code terminal for debugging purposes where
 // backspace is encoded 0x7f
 //
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fstream>
+#include <string_view>
 #include <termios.h>
 #include <unistd.h>
-#include <vector>
+
+#include "../../emulator/src/mapped_file.hpp"
+// file mapping shared with the emulator
 
 static auto initiate_bss() -> void {}
 // note: bss section is initialized by the environment
@@ -24,60 +27,38 @@ static char constexpr char_carriage_return = '\x0a';
 #include "os_common.hpp"
 // the platform independent source
 
-// initialize SD card 8 MB
-static std::vector<uint8_t> sdcard(8 * 1024 * 1024, 0);
-static size_t constexpr sdcard_sector_size_bytes = 512;
-
-static auto load_file(char const* file_name, char const* data_name,
-                      std::vector<uint8_t>& data) -> bool {
-
-    using namespace std;
-
-    ifstream file{file_name, ios::binary | ios::ate};
-    if (!file) {
-        printf("%s: error opening file '%s'\n", data_name, file_name);
-        return false;
-    }
-
-    streamsize const size = file.tellg();
-    if (size == -1) {
-        printf("%s: error determining size of file '%s'\n", data_name,
-               file_name);
-        return false;
-    }
-
-    if (size > streamsize(data.size())) {
-        printf(
-            "%s: size of file (%zu B) exceeds size of data container (%zu B)\n",
-            data_name, size, data.size());
-        return false;
-    }
-
-    file.seekg(0, ios::beg);
-    if (file.fail()) {
-        printf("%s: error seeking to beginning of file '%s'\n", data_name,
-               file_name);
-        return false;
-    }
-
-    if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
-        printf("%s: error reading file '%s'\n", data_name, file_name);
-        return false;
-    }
+// SD card image mapped from file
+static mapped_file sdcard;
 
-    file.close();
-
-    return true;
-}
+// SD card is at least 8 MB with bytes beyond the image being zero
+static size_t constexpr sdcard_min_size = 8 * 1024 * 1024;
+static size_t constexpr sdcard_sector_size_bytes = 512;
 
 auto main(int argc, char* argv[]) -> int {
 
-    if (argc != 2) {
-        printf("Usage: %s <sdcard.bin>\n", argv[0]);
+    bool sdcard_write_back = false;
+    char const* sdcard_file = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        if (arg == "--sdcard-write-back") {
+            sdcard_write_back = true;
+        } else if (arg.starts_with("--") || sdcard_file) {
+            sdcard_file = nullptr;
+            break;
+        } else {
+            sdcard_file = argv[i];
+        }
+    }
+    if (!sdcard_file) {
+        printf("Usage: %s [--sdcard-write-back] <sdcard.bin>\n", argv[0]);
+        printf("  --sdcard-write-back  write SD card sectors to the image "
+               "file\n"
+               "                       that is extended to 8 MB if smaller\n");
         return 1;
     }
 
-    if (!load_file(argv[1], "SD card", sdcard)) {
+    if (!sdcard.map(sdcard_file, "SD card", sdcard_min_size,
+                    sdcard_write_back)) {
         return 2;
     }
 
@@ -101,6 +82,8 @@ static auto uart_send_cstr(char const* str) -> void { printf("%s", str); }
 
 static auto uart_read_char() -> char { return char(getchar()); }
 
+static auto uart_send_queued() -> void {}
+
 static auto led_set(uint32_t const bits) -> void {}
 
 static auto action_mem_test() -> void {
@@ -117,23 +100,30 @@ static auto action_sdcard_status() -> void {
 
 static auto sdcard_read_blocking(size_t const sector, int8_t* buffer512B)
     -> void {
-    int64_t const ix = int64_t(sector * sdcard_sector_size_bytes);
-    auto const bgn = sdcard.begin() + ix;
-    auto const end = bgn + sdcard_sector_size_bytes;
-    if (end > sdcard.end()) {
+    size_t const offset = sector * sdcard_sector_size_bytes;
+    if (offset + sdcard_sector_size_bytes > sdcard.size()) {
         return;
     }
-    copy(bgn, end, buffer512B);
+    uint8_t const* const bgn = sdcard.data() + offset;
+    std::copy(bgn, bgn + sdcard_sector_size_bytes, buffer512B);
+}
+
+template <typename F>
+static auto sdcard_read_sectors(size_t const sector, size_t const count,
+                                F consume) -> void {
+    int8_t buf[sdcard_sector_size_bytes]{};
+    for (size_t i = 0; i < count; ++i) {
+        sdcard_read_blocking(sector + i, buf);
+        consume(sector + i, buf);
+    }
 }
 
 static auto sdcard_write_blocking(size_t const sector, int8_t const* buffer512B)
     -> void {
-    int64_t const ix = int64_t(sector * sdcard_sector_size_bytes);
-    auto const dst = sdcard.begin() + ix;
-    auto const bgn = buffer512B;
-    auto const end = bgn + sdcard_sector_size_bytes;
-    if (dst + sdcard_sector_size_bytes > sdcard.end()) {
+    size_t const offset = sector * sdcard_sector_size_bytes;
+    if (offset + sdcard_sector_size_bytes > sdcard.size()) {
         return;
     }
-    copy(bgn, end, dst);
+    std::copy(buffer512B, buffer512B + sdcard_sector_size_bytes,
+              sdcard.data() + offset);
 }
@@ -36,29 +36,79 @@ static char constexpr char_carriage_return = '\x0d';
 #include "os_common.hpp"
 // the platform independent source
 
+using word = uint32_t [[gnu::may_alias]];
+using half_word = uint16_t [[gnu::may_alias]];
+// RAM accessed a word or half word at a time regardless of the type of the
+// objects it holds
+
 // FPGA I/O
 
 static auto led_set(uint32_t const bits) -> void { *LED = bits; }
 
-static auto uart_send_cstr(char const* str) -> void {
-    while (*str) {
-        while (*UART_OUT != -1)
-            ;
-        *UART_OUT = *str++;
+// UART receive queue
+//  'UART_IN' keeps few characters thus it is drained while waiting for input
+//  and while waiting for room in the transmit queue during long output
+static size_t constexpr uart_rx_queue_size = 256; // power of 2
+static char uart_rx_queue[uart_rx_queue_size];
+static size_t uart_rx_head; // next to read
+static size_t uart_rx_tail; // next free
+
+static auto uart_receive_queued() -> void {
+    while (true) {
+        size_t const next = (uart_rx_tail + 1) & (uart_rx_queue_size - 1);
+        if (next == uart_rx_head) {
+            // queue full; leave input in 'UART_IN'
+            return;
+        }
+        int const ch = *UART_IN;
+        if (ch == -1) {
+            return;
+        }
+        uart_rx_queue[uart_rx_tail] = char(ch);
+        uart_rx_tail = next;
+    }
+}
+
+// UART transmit queue
+//  characters are queued and sent when 'UART_OUT' is ready, polled while
+//  waiting for input, from the main loop and when the queue is full
+static size_t constexpr uart_tx_queue_size = 1024; // power of 2
+static char uart_tx_queue[uart_tx_queue_size];
+static size_t uart_tx_head; // next to send
+static size_t uart_tx_tail; // next free
+
+static auto uart_send_queued() -> void {
+    while (uart_tx_head != uart_tx_tail && *UART_OUT == -1) {
+        *UART_OUT = uart_tx_queue[uart_tx_head];
+        uart_tx_head = (uart_tx_head + 1) & (uart_tx_queue_size - 1);
     }
 }
 
 static auto uart_send_char(char const ch) -> void {
-    while (*UART_OUT != -1)
-        ;
-    *UART_OUT = ch;
+    size_t const next = (uart_tx_tail + 1) & (uart_tx_queue_size - 1);
+    while (next == uart_tx_head) {
+        uart_receive_queued();
+        uart_send_queued();
+    }
+    uart_tx_queue[uart_tx_tail] = ch;
+    uart_tx_tail = next;
+    uart_send_queued();
+}
+
+static auto uart_send_cstr(char const* str) -> void {
+    while (*str) {
+        uart_send_char(*str++);
+    }
 }
 
 static auto uart_read_char() -> char {
-    int ch;
-    while ((ch = *UART_IN) == -1)
-        ;
-    return char(ch);
+    while (uart_rx_head == uart_rx_tail) {
+        uart_send_queued();
+        uart_receive_queued();
+    }
+    char const ch = uart_rx_queue[uart_rx_head];
+    uart_rx_head = (uart_rx_head + 1) & (uart_rx_queue_size - 1);
+    return ch;
 }
 
 // simple test of FPGA memory
@@ -109,6 +159,23 @@ static auto action_sdcard_status() -> void {
     uart_send_cstr("\r\n");
 }
 
+// copies the sector read by the SD card to 'buffer512B'
+//  note: a word at a time when 'buffer512B' is word aligned
+static auto sdcard_read_buffer(int8_t* buffer512B) -> void {
+    if (!(uint32_t(buffer512B) & 3)) {
+        word* dst = static_cast<word*>(static_cast<void*>(buffer512B));
+        for (size_t i = 0; i < 512 / 4; ++i) {
+            *dst = *SDCARD_NEXT_WORD;
+            ++dst;
+        }
+        return;
+    }
+    for (size_t i = 0; i < 512; ++i) {
+        *buffer512B = char(*SDCARD_NEXT_BYTE);
+        ++buffer512B;
+    }
+}
+
 static auto sdcard_read_blocking(size_t const sector, int8_t* buffer512B)
     -> void {
     while (*SDCARD_BUSY)
@@ -116,9 +183,31 @@ static auto sdcard_read_blocking(size_t const sector, int8_t* buffer512B)
     *SDCARD_READ_SECTOR = sector;
     while (*SDCARD_BUSY)
         ;
-    for (size_t i = 0; i < 512; ++i) {
-        *buffer512B = char(*SDCARD_NEXT_BYTE);
-        ++buffer512B;
+    sdcard_read_buffer(buffer512B);
+}
+
+// reads 'count' sectors starting at 'sector' and calls
+// 'consume(sector, buffer512B)' for each
+//  note: the read of the next sector is started before 'consume' is called
+//        thus the SD card reads while the previous sector is processed
+template <typename F>
+static auto sdcard_read_sectors(size_t const sector, size_t const count,
+                                F consume) -> void {
+    if (count == 0) {
+        return;
+    }
+    alignas(4) int8_t buf[512];
+    while (*SDCARD_BUSY)
+        ;
+    *SDCARD_READ_SECTOR = sector;
+    for (size_t i = 0; i < count; ++i) {
+        while (*SDCARD_BUSY)
+            ;
+        sdcard_read_buffer(buf);
+        if (i + 1 < count) {
+            *SDCARD_READ_SECTOR = sector + i + 1;
+        }
+        consume(sector + i, buf);
     }
 }
 
@@ -126,40 +215,188 @@ static auto sdcard_write_blocking(size_t const sector, int8_t const* buffer512B)
     -> void {
     while (*SDCARD_BUSY)
         ;
-    for (size_t i = 0; i < 512; ++i) {
-        *SDCARD_NEXT_BYTE = *buffer512B;
-        ++buffer512B;
+    if (!(uint32_t(buffer512B) & 3)) {
+        word const* src =
+            static_cast<word const*>(static_cast<void const*>(buffer512B));
+        for (size_t i = 0; i < 512 / 4; ++i) {
+            *SDCARD_NEXT_WORD = *src;
+            ++src;
+        }
+    } else {
+        for (size_t i = 0; i < 512; ++i) {
+            *SDCARD_NEXT_BYTE = *buffer512B;
+            ++buffer512B;
+        }
     }
     *SDCARD_WRITE_SECTOR = sector;
     while (*SDCARD_BUSY)
         ;
 }
 
-// built-in function called by compiler
-extern "C" auto memset(void* str, int ch, int n) -> void* {
-    char* ptr = reinterpret_cast<char*>(str);
-    while (n--) {
-        *ptr = char(ch);
-        ++ptr;
+// built-in functions called by compiler
+//  note: RAM is accessed a word at a time when the pointers have the same
+//        alignment since the core does not support misaligned access
+//  note: loops must not be replaced by calls to these functions
+
+extern "C" [[gnu::optimize("no-tree-loop-distribute-patterns")]] auto
+memset(void* str, int ch, size_t n) -> void* {
+    uint8_t* p = reinterpret_cast<uint8_t*>(str);
+    uint8_t const b = uint8_t(ch);
+    while (n && (uint32_t(p) & 3)) {
+        *p++ = b;
+        --n;
+    }
+    uint32_t w = b;
+    w |= w << 8;
+    w |= w << 16;
+    // byte in all lanes by shifts; rv32i has no multiply
+    word* pw = static_cast<word*>(static_cast<void*>(p));
+    while (n >= 16) {
+        pw[0] = w;
+        pw[1] = w;
+        pw[2] = w;
+        pw[3] = w;
+        pw += 4;
+        n -= 16;
+    }
+    while (n >= 4) {
+        *pw++ = w;
+        n -= 4;
+    }
+    p = reinterpret_cast<uint8_t*>(pw);
+    if (n & 2) {
+        *static_cast<half_word*>(static_cast<void*>(p)) = uint16_t(w);
+        p += 2;
+    }
+    if (n & 1) {
+        *p = b;
     }
     return str;
 }
 
-// built-in function called by compiler
-extern "C" auto memcpy(void* dst, void const* src, size_t n) -> void* {
-    char* p1 = reinterpret_cast<char*>(dst);
-    char const* p2 = reinterpret_cast<char const*>(src);
-    while (n--) {
+extern "C" [[gnu::optimize("no-tree-loop-distribute-patterns")]] auto
+memcpy(void* dst, void const* src, size_t n) -> void* {
+    uint8_t* p1 = reinterpret_cast<uint8_t*>(dst);
+    uint8_t const* p2 = reinterpret_cast<uint8_t const*>(src);
+    if ((uint32_t(p1) ^ uint32_t(p2)) & 3) {
+        // different alignment
+        while (n >= 4) {
+            p1[0] = p2[0];
+            p1[1] = p2[1];
+            p1[2] = p2[2];
+            p1[3] = p2[3];
+            p1 += 4;
+            p2 += 4;
+            n -= 4;
+        }
+        while (n--) {
+            *p1++ = *p2++;
+        }
+        return dst;
+    }
+    while (n && (uint32_t(p1) & 3)) {
+        *p1++ = *p2++;
+        --n;
+    }
+    word* w1 = static_cast<word*>(static_cast<void*>(p1));
+    word const* w2 = static_cast<word const*>(static_cast<void const*>(p2));
+    while (n >= 16) {
+        w1[0] = w2[0];
+        w1[1] = w2[1];
+        w1[2] = w2[2];
+        w1[3] = w2[3];
+        w1 += 4;
+        w2 += 4;
+        n -= 16;
+    }
+    while (n >= 4) {
+        *w1++ = *w2++;
+        n -= 4;
+    }
+    p1 = reinterpret_cast<uint8_t*>(w1);
+    p2 = reinterpret_cast<uint8_t const*>(w2);
+    if (n & 2) {
+        p1[0] = p2[0];
+        p1[1] = p2[1];
+        p1 += 2;
+        p2 += 2;
+    }
+    if (n & 1) {
         *p1 = *p2;
+    }
+    return dst;
+}
+
+// copies backwards when destination overlaps the end of source
+extern "C" [[gnu::optimize("no-tree-loop-distribute-patterns")]] auto
+memmove(void* dst, void const* src, size_t n) -> void* {
+    uint8_t* p1 = reinterpret_cast<uint8_t*>(dst);
+    uint8_t const* p2 = reinterpret_cast<uint8_t const*>(src);
+    if (p1 <= p2 || p1 >= p2 + n) {
+        return memcpy(dst, src, n);
+    }
+    p1 += n;
+    p2 += n;
+    if (!((uint32_t(p1) ^ uint32_t(p2)) & 3)) {
+        while (n && (uint32_t(p1) & 3)) {
+            *--p1 = *--p2;
+            --n;
+        }
+        word* w1 = static_cast<word*>(static_cast<void*>(p1));
+        word const* w2 =
+            static_cast<word const*>(static_cast<void const*>(p2));
+        while (n >= 4) {
+            *--w1 = *--w2;
+            n -= 4;
+        }
+        p1 = reinterpret_cast<uint8_t*>(w1);
+        p2 = reinterpret_cast<uint8_t const*>(w2);
+    }
+    while (n--) {
+        *--p1 = *--p2;
+    }
+    return dst;
+}
+
+extern "C" [[gnu::optimize("no-tree-loop-distribute-patterns")]] auto
+memcmp(void const* lhs, void const* rhs, size_t n) -> int {
+    uint8_t const* p1 = reinterpret_cast<uint8_t const*>(lhs);
+    uint8_t const* p2 = reinterpret_cast<uint8_t const*>(rhs);
+    if (!((uint32_t(p1) ^ uint32_t(p2)) & 3)) {
+        while (n && (uint32_t(p1) & 3)) {
+            if (*p1 != *p2) {
+                return *p1 - *p2;
+            }
+            ++p1;
+            ++p2;
+            --n;
+        }
+        // skip equal words; a differing word is compared by bytes below
+        word const* w1 =
+            static_cast<word const*>(static_cast<void const*>(p1));
+        word const* w2 =
+            static_cast<word const*>(static_cast<void const*>(p2));
+        while (n >= 4 && *w1 == *w2) {
+            ++w1;
+            ++w2;
+            n -= 4;
+        }
+        p1 = reinterpret_cast<uint8_t const*>(w1);
+        p2 = reinterpret_cast<uint8_t const*>(w2);
+    }
+    while (n--) {
+        if (*p1 != *p2) {
+            return *p1 - *p2;
+        }
         ++p1;
         ++p2;
     }
-    return dst;
+    return 0;
 }
 
 // zero bss section
 static auto initiate_bss() -> void {
-    memset(&__bss_start, 0, &__bss_end - &__bss_start);
+    memset(&__bss_start, 0, size_t(&__bss_end - &__bss_start));
 }
 
 static auto initiate_statics() -> void {}
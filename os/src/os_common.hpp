@@ -125,6 +125,9 @@ static auto action_take(entity_id_t eid, string args) -> void;
 static auto input(command_buffer& cmd_buf) -> void;
 static auto handle_input(entity_id_t eid, command_buffer& cmd_buf) -> void;
 static auto sdcard_read_blocking(size_t sector, int8_t* buffer512B) -> void;
+template <typename F>
+static auto sdcard_read_sectors(size_t sector, size_t count, F consume)
+    -> void;
 static auto sdcard_write_blocking(size_t sector, int8_t const* buffer512B)
     -> void;
 static auto string_equals_cstr(string str, cstr s) -> bool;
@@ -139,6 +142,7 @@ static auto led_set(uint32_t bits) -> void;
 static auto uart_send_cstr(cstr str) -> void;
 static auto uart_send_char(char ch) -> void;
 static auto uart_read_char() -> char;
+static auto uart_send_queued() -> void;
 static auto uart_send_move_back(size_t n) -> void;
 static auto action_mem_test() -> void;
 static auto action_sdcard_status() -> void;
@@ -162,6 +166,8 @@ extern "C" [[noreturn]] auto run() -> void {
     mut cmd_buf = command_buffer{};
 
     while (true) {
+        // send output while the UART is ready
+        uart_send_queued();
         mut& ent = entity_by_id(active_entity);
         print_location(ent.location, active_entity);
         uart_send_cstr(ent.name);
@@ -451,16 +457,18 @@ static auto action_give(entity_id_t const eid, string const args) -> void {
 static auto action_sdcard_read(string const args) -> void {
     let w1 = string_next_word(args);
     if (w1.word.is_empty()) {
-        uart_send_cstr("<sector>\r\n");
+        uart_send_cstr("<sector> [count]\r\n");
         return;
     }
     let sector = string_to_uint32(w1.word);
-    int8_t buf[512];
-    sdcard_read_blocking(sector, buf);
-    for (mut i = 0u; i < sizeof(buf); ++i) {
-        uart_send_char(buf[i]);
-    }
-    uart_send_cstr("\r\n");
+    let w2 = string_next_word(w1.rem);
+    let count = w2.word.is_empty() ? 1u : string_to_uint32(w2.word);
+    sdcard_read_sectors(sector, count, [](size_t, int8_t const* buf) {
+        for (mut i = 0u; i < 512; ++i) {
+            uart_send_char(buf[i]);
+        }
+        uart_send_cstr("\r\n");
+    });
 }
 
 static auto action_sdcard_write(string const args) -> void {
@@ -469,7 +477,7 @@ static auto action_sdcard_write(string const args) -> void {
         uart_send_cstr("<sector> <text>\r\n");
         return;
     }
-    int8_t buf[512]{};
+    alignas(4) int8_t buf[512]{};
     if (w1.rem.size() > sizeof(buf)) {
         uart_send_cstr("<text> exceeds sector size\r\n");
         return;
@@ -489,8 +497,9 @@ static auto print_help() -> void {
         "w: go west\r\n  i: display inventory\r\n  t <object>: take object\r\n "
         " "
         "d <object>: drop object\r\n  g <object> <entity>: give object to "
-        "entity\r\n  sdr <sector>: read sector from SD card\r\n  sdw <sector> "
-        "<text>: write sector to SD card\r\n  help: this message\r\n\r\n");
+        "entity\r\n  sdr <sector> [count]: read sectors from SD card\r\n  sdw "
+        "<sector> <text>: write sector to SD card\r\n  help: this "
+        "message\r\n\r\n");
 }
 
 static auto input(command_buffer& cmd_buf) -> void {
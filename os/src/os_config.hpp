@@ -8,4 +8,5 @@
 #define SDCARD_NEXT_BYTE ((int volatile *)0xffff'ffe8)
 #define SDCARD_STATUS ((unsigned volatile *)0xffff'ffe4)
 #define SDCARD_WRITE_SECTOR ((unsigned volatile *)0xffff'ffe0)
+#define SDCARD_NEXT_WORD ((unsigned volatile *)0xffff'ffdc)
 #define MEMORY_END 0x800000
@@ -50,7 +50,7 @@ module testbench;
   logic [2:0] command;
   logic [31:0] sector;
   wire [7:0] data_out;
-  logic [7:0] data_in;
+  logic [31:0] data_in;
   wire busy;
   wire [31:0] status;
   wire sd_cs_n;
@@ -105,16 +105,16 @@ module testbench;
     //   $display("%0d: %h", i, sd_card.buffer[i]);
     // end
 
-    assert (sdcard.buffer[0] == 8'h42)
+    assert (sdcard.buffer.data[0][7:0] == 8'h42)
     else $fatal;
 
-    assert (sdcard.buffer[1] == 8'h20)
+    assert (sdcard.buffer.data[0][15:8] == 8'h20)
     else $fatal;
 
-    assert (sdcard.buffer[4] == 8'h00)
+    assert (sdcard.buffer.data[1][7:0] == 8'h00)
     else $fatal;
 
-    assert (sdcard.buffer[5] == 8'h6e)
+    assert (sdcard.buffer.data[1][15:8] == 8'h6e)
     else $fatal;
 
     command <= 2;
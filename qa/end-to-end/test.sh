@@ -8,7 +8,10 @@ cd $(dirname "$0")
 
 TTY=/dev/ttyUSB1
 BAUD=115200
-SLP=0.5
+SLP=${SLP:-0.5}
+# seconds between commands; firmware queues input received while printing and
+#  'UART_RX_FIFO_DEPTH_BITWIDTH' in 'configuration.py' queues input in 'ramio'
+#  thus input can be sent without delay, e.g. 'SLP=0 ./test.sh'
 
 # capture ctrl+c and kill cat
 trap 'kill $(jobs -p); exit 130' INT
@@ -1,8 +1,14 @@
 #!/bin/sh
 set -e
+export SD_FAKE=${SD_FAKE:+$(realpath "$SD_FAKE")}
 cd $(dirname "$0")
 
-for i in 1 2 3 4 5 6 7 8; do
+TESTS="1 2 3 4 5 6 7 8 11"
+if [ -n "$SD_FAKE" ]; then
+    TESTS="$TESTS 9 10 12"
+fi
+
+for i in $TESTS; do
     echo -n "test $i: "
     ./testbench.sh $i 2>&1 | grep -E "PASSED|FATAL"
 done
@@ -5,6 +5,10 @@
 #        vvp: Icarus Verilog runtime version 12.0 (stable)
 #
 set -e
+
+# SD card model used by tests 9, 10 and 12 (see 'README.md')
+SDFAKE=${SD_FAKE:+$(realpath "$SD_FAKE")}
+
 cd $(dirname "$0")
 
 SRCPTH=../../src
@@ -23,7 +27,8 @@ iverilog -g2012 -Winfloop -pfileline=1 -o iverilog.vvp -s testbench testbench.sv
     $SRCPTH/registers.sv \
     $SRCPTH/core.sv \
     $SRCPTH/emulators/burst_ram.sv \
-    $SRCPTH/emulators/flash.sv
+    $SRCPTH/emulators/flash.sv \
+    $SDFAKE
 
 vvp iverilog.vvp
 rm iverilog.vvp
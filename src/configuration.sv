@@ -9,8 +9,20 @@ package configuration;
   parameter int unsigned CACHE_COLUMN_INDEX_BITWIDTH = 3;
   parameter int unsigned CACHE_LINE_INDEX_BITWIDTH = 7;
   parameter int unsigned UART_BAUD_RATE = 115200;
+  parameter int unsigned UART_RX_FIFO_DEPTH_BITWIDTH = 0;
   parameter int unsigned FLASH_TRANSFER_FROM_ADDRESS = 32'h00000000;
   parameter int unsigned FLASH_TRANSFER_BYTE_COUNT = 32'h00200000;
   parameter int unsigned STARTUP_WAIT_CYCLES = 1000000;
 
+  parameter int unsigned ADDRESS_LED = 32'hffff_fffc;
+  parameter int unsigned ADDRESS_UART_OUT = 32'hffff_fff8;
+  parameter int unsigned ADDRESS_UART_IN = 32'hffff_fff4;
+  parameter int unsigned ADDRESS_SDCARD_BUSY = 32'hffff_fff0;
+  parameter int unsigned ADDRESS_SDCARD_READ_SECTOR = 32'hffff_ffec;
+  parameter int unsigned ADDRESS_SDCARD_NEXT_BYTE = 32'hffff_ffe8;
+  parameter int unsigned ADDRESS_SDCARD_STATUS = 32'hffff_ffe4;
+  parameter int unsigned ADDRESS_SDCARD_WRITE_SECTOR = 32'hffff_ffe0;
+  parameter int unsigned ADDRESS_SDCARD_NEXT_WORD = 32'hffff_ffdc;
+  parameter int unsigned ADDRESS_IO_PORTS_START = 32'hffff_ffdc;
+
 endpackage
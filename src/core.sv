@@ -460,6 +460,45 @@ module core #(
     end
   end
 
+`ifdef RETIREMENT_TRACE
+  // writes a line per retired instruction to 'retirement.trace' for
+  // 'emulator/osqa --lockstep'
+  //  "<pc> <rd> <rd value> <store type> <store address> <store data>"
+  //  rd is 0 when no register is written and store type 0 when not a store
+  integer trace_file;
+  logic trace_pending;
+  logic [31:0] trace_pc;
+  logic [1:0] trace_store_type;
+  logic [31:0] trace_store_address;
+  logic [31:0] trace_store_data;
+
+  initial trace_file = $fopen("retirement.trace", "w");
+
+  always_ff @(posedge clk) begin
+    if (!rst_n) begin
+      trace_pending <= 0;
+    end else begin
+      if (state == CpuExecute) begin
+        trace_pending <= 1;
+        trace_pc <= pc;
+        trace_store_type <= 0;
+      end
+      if (state == CpuStore && !ramio_busy) begin
+        trace_store_type <= ramio_write_type;
+        trace_store_address <= ramio_address;
+        trace_store_data <= ramio_data_in;
+      end
+      if (state == CpuFetch && trace_pending) begin
+        // first cycle of fetch: register of retired instruction is written
+        $fdisplay(trace_file, "%h %0d %h %0d %h %h", trace_pc,
+                  rd_write_enable ? rd : 5'd0, rd_data_in, trace_store_type,
+                  trace_store_address, trace_store_data);
+        trace_pending <= 0;
+      end
+    end
+  end
+`endif
+
   registers registers (
       .clk,
       .rs1,
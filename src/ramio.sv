@@ -32,6 +32,10 @@ module ramio #(
     parameter int unsigned BaudRate = 115200,
     // passed to 'uartrx' and 'uarttx'
 
+    parameter int unsigned UartRxFifoDepthBitwidth = 0,
+    // 0: one received byte that is overrun by the next
+    // n: 2 ^ n received bytes queued; bytes received when full are dropped
+
     parameter int unsigned AddressLed = 32'hffff_fffc,
     // 4 LEDs in the lower nibble of the int
     // note: 0 is led on, 1 is led off
@@ -40,7 +44,7 @@ module ramio #(
     // note: returns -1 if idle
 
     parameter int unsigned AddressUartIn = 32'hffff_fff4,
-    // note: is set to -1 after read
+    // note: returns -1 if no data received; read removes the data
 
     parameter int unsigned AddressSDCardBusy = 32'hffff_fff0,
 
@@ -52,7 +56,11 @@ module ramio #(
 
     parameter int unsigned AddressSDCardWriteSector = 32'hffff_ffe0,
 
-    parameter int unsigned AddressIOPortsStart = 32'hffff_ffe0,
+    parameter int unsigned AddressSDCardNextWord = 32'hffff_ffdc,
+    // 4 bytes of the sector buffer, little endian, per read or write
+    // note: buffer index must be a multiple of 4
+
+    parameter int unsigned AddressIOPortsStart = 32'hffff_ffdc,
     // where mapping of I/O ports start
 
     parameter bit SDCardSimulate = 0,
@@ -132,7 +140,8 @@ module ramio #(
                 address == AddressSDCardReadSector ||
                 address == AddressSDCardWriteSector ||
                 address == AddressSDCardNextByte ||
-                address == AddressSDCardStatus
+                address == AddressSDCardStatus ||
+                address == AddressSDCardNextWord
                 ? 0 : cache_busy;
 
   assign data_out_ready = address == AddressUartOut ||
@@ -142,7 +151,8 @@ module ramio #(
                           address == AddressSDCardReadSector ||
                           address == AddressSDCardWriteSector ||
                           address == AddressSDCardNextByte ||
-                          address == AddressSDCardStatus
+                          address == AddressSDCardStatus ||
+                          address == AddressSDCardNextWord
                           ? 1 : cache_data_out_ready;
 
   // note: commented lines use 280 more LUT than the cumbersome code above
@@ -154,7 +164,8 @@ module ramio #(
   logic [2:0] sdcard_command;
   logic [31:0] sdcard_sector;
   wire [7:0] sdcard_data_out;
-  logic [7:0] sdcard_data_in;
+  wire [31:0] sdcard_data_out_word;
+  logic [31:0] sdcard_data_in;
   wire sdcard_busy;
   wire [31:0] sdcard_status;
 
@@ -164,6 +175,7 @@ module ramio #(
 
   logic [31:0] uartrx_data_received;
   // data copied from 'uartrx_data' when 'uartrx_data_ready' asserted
+  //  or first byte in FIFO
   //  -1 if none available
 
 
@@ -206,7 +218,11 @@ module ramio #(
           AddressSDCardStatus: ;  // ignore write
           AddressSDCardNextByte: begin
             sdcard_command = 3;
-            sdcard_data_in = data_in[7:0];
+            sdcard_data_in = {24'b0, data_in[7:0]};
+          end
+          AddressSDCardNextWord: begin
+            sdcard_command = 6;
+            sdcard_data_in = data_in;
           end
           AddressSDCardReadSector: begin
             sdcard_command = 1;
@@ -296,6 +312,10 @@ module ramio #(
             sdcard_command = 2;
             data_out = sdcard_data_out;
           end
+          AddressSDCardNextWord: begin
+            sdcard_command = 5;
+            data_out = sdcard_data_out_word;
+          end
           default: begin
             cache_enable = 1;
             // read from ram
@@ -372,33 +392,7 @@ module ramio #(
       led <= 4'b1111;  // turn off all LEDs
       uarttx_data_sending <= -1;
       uarttx_go <= 0;
-      uartrx_data_received <= -1;
-      uartrx_go <= 1;
     end else begin
-      // if read from UART then reset the read data to -1
-      if (address == AddressUartIn && read_type != 0) begin
-`ifdef DBG
-        $display("%m: %0t: uart read  uartrx_data_received: %h", $time, uartrx_data_received);
-`endif
-        uartrx_data_received <= -1;
-      end
-
-      if (uartrx_go && uartrx_data_ready) begin
-`ifdef DBG
-        $display("%m: %0t: uart data ready  uartrx_data_received: %h", $time, uartrx_data);
-`endif
-        // if UART has data ready then copy the data and acknowledge (uartrx_go = 0)
-        //  note: read data can be overrun
-        uartrx_data_received <= {{24'h00}, uartrx_data};
-        uartrx_go <= 0;
-      end
-
-      // if previous cycle acknowledged receiving data
-      //  then start receiving next data (uartrx_go = 1)
-      if (!uartrx_go) begin
-        uartrx_go <= 1;
-      end
-
       // if UART is done sending data then acknowledge (uarttx_go = 0)
       //  and set idle (0xffff'ffff)
       if (uarttx_go && !uarttx_busy) begin
@@ -419,6 +413,101 @@ module ramio #(
     end
   end
 
+  generate
+    if (UartRxFifoDepthBitwidth == 0) begin : uartrx_register
+
+      always_ff @(posedge clk) begin
+        if (!rst_n) begin
+          uartrx_data_received <= -1;
+          uartrx_go <= 1;
+        end else begin
+          // if read from UART then reset the read data to -1
+          if (address == AddressUartIn && read_type != 0) begin
+`ifdef DBG
+            $display("%m: %0t: uart read  uartrx_data_received: %h", $time,
+                     uartrx_data_received);
+`endif
+            uartrx_data_received <= -1;
+          end
+
+          if (uartrx_go && uartrx_data_ready) begin
+`ifdef DBG
+            $display("%m: %0t: uart data ready  uartrx_data_received: %h", $time, uartrx_data);
+`endif
+            // if UART has data ready then copy the data and acknowledge (uartrx_go = 0)
+            //  note: read data can be overrun
+            uartrx_data_received <= {{24'h00}, uartrx_data};
+            uartrx_go <= 0;
+          end
+
+          // if previous cycle acknowledged receiving data
+          //  then start receiving next data (uartrx_go = 1)
+          if (!uartrx_go) begin
+            uartrx_go <= 1;
+          end
+        end
+      end
+
+    end else begin : uartrx_fifo
+
+      localparam int unsigned Depth = 2 ** UartRxFifoDepthBitwidth;
+
+      logic [7:0] fifo[Depth];
+
+      logic [UartRxFifoDepthBitwidth:0] read_index;
+      logic [UartRxFifoDepthBitwidth:0] write_index;
+      // note: one extra bit to tell full from empty
+
+      wire empty = read_index == write_index;
+      wire full = read_index[UartRxFifoDepthBitwidth-1:0] ==
+                  write_index[UartRxFifoDepthBitwidth-1:0] &&
+                  read_index[UartRxFifoDepthBitwidth] != write_index[UartRxFifoDepthBitwidth];
+
+      always_comb begin
+        uartrx_data_received = empty ? -1 :
+            {{24'h00}, fifo[read_index[UartRxFifoDepthBitwidth-1:0]]};
+      end
+
+      always_ff @(posedge clk) begin
+        if (!rst_n) begin
+          read_index <= 0;
+          write_index <= 0;
+          uartrx_go <= 1;
+        end else begin
+          // if read from UART then remove the read data
+          if (address == AddressUartIn && read_type != 0 && !empty) begin
+`ifdef DBG
+            $display("%m: %0t: uart read  uartrx_data_received: %h", $time,
+                     uartrx_data_received);
+`endif
+            read_index <= read_index + 1'b1;
+          end
+
+          if (uartrx_go && uartrx_data_ready) begin
+`ifdef DBG
+            $display("%m: %0t: uart data ready  uartrx_data: %h  full: %0d", $time, uartrx_data,
+                     full);
+`endif
+            // if UART has data ready then queue the data and acknowledge (uartrx_go = 0)
+            //  note: data is dropped when FIFO is full
+            if (!full) begin
+              fifo[write_index[UartRxFifoDepthBitwidth-1:0]] <= uartrx_data;
+              write_index <= write_index + 1'b1;
+            end
+            uartrx_go <= 0;
+          end
+
+          // if previous cycle acknowledged receiving data
+          //  then start receiving next data (uartrx_go = 1)
+          if (!uartrx_go) begin
+            uartrx_go <= 1;
+          end
+        end
+      end
+
+    end
+  endgenerate
+
   cache #(
       .LineIndexBitwidth (CacheLineIndexBitwidth),
       .RamAddressBitwidth(RamAddressBitwidth),
@@ -502,6 +591,7 @@ module ramio #(
       .command(sdcard_command),
       .sector(sdcard_sector),
       .data_out(sdcard_data_out),
+      .data_out_word(sdcard_data_out_word),
       .data_in(sdcard_data_in),
       .busy(sdcard_busy),
       .status(sdcard_status)
@@ -29,6 +29,9 @@ module sdcard #(
     // 2: update 'data_out' with next byte in buffer
     // 3: write 'data_in' to buffer and increment index
     // 4: write buffer to sector specified by 'sector'
+    // 5: update 'data_out_word' with next 4 bytes in buffer
+    // 6: write 'data_in' 4 bytes to buffer and increment index by 4
+    // note: commands 5 and 6 expect buffer index to be a multiple of 4
 
     input wire [31:0] sector,
     // sector to read with 'command' 1 and write with 'command' 3
@@ -36,8 +39,11 @@ module sdcard #(
     output logic [7:0] data_out,
     // data at current buffer index
 
-    input wire [7:0] data_in,
-    // data to write when 'command' is 3
+    output logic [31:0] data_out_word,
+    // 4 bytes at current buffer index, little endian
+
+    input wire [31:0] data_in,
+    // data to write: byte in [7:0] when 'command' is 3, word when 6
 
     output logic busy,
     // true while reading or writing SD card
@@ -52,8 +58,27 @@ module sdcard #(
     input  wire  sd_miso
 );
 
-  logic [7:0] buffer[512];
   logic [8:0] buffer_index;
+  // byte index
+
+  wire [6:0] buffer_word_index = buffer_index[8:2];
+  wire [4:0] buffer_byte_shift = {buffer_index[1:0], 3'b000};
+  wire [3:0] buffer_byte_lane = 4'b0001 << buffer_index[1:0];
+
+  logic [3:0] buffer_write_enable;
+  logic [31:0] buffer_data_in;
+
+  // 512 B sector as words for 4 bytes access, little endian
+  //  note: one read and one byte enabled write port thus one block RAM
+  bram #(
+      .AddressBitwidth(7)
+  ) buffer (
+      .clk,
+      .write_enable(buffer_write_enable),
+      .address(buffer_word_index),
+      .data_out(data_out_word),
+      .data_in(buffer_data_in)
+  );
 
   // related to 'sd_controller'
   logic rd;
@@ -82,13 +107,30 @@ module sdcard #(
 
   state_e state;
 
-  assign data_out = buffer[buffer_index];
+  // note: byte is selected from the word thus buffer has one read port
+  assign data_out = data_out_word[buffer_byte_shift+:8];
   assign busy = state != Idle;
 
   // wiring of 'sd_controller' status to 32 bit output
   wire [4:0] status_in;
   assign status = {27'b0, status_in};
 
+  // writes to buffer: byte is written to all lanes with the lane at
+  // 'buffer_index' enabled
+  always_comb begin
+    buffer_write_enable = 0;
+    buffer_data_in = data_in;
+    if (rst_n && state == Idle && command == 3) begin
+      buffer_write_enable = buffer_byte_lane;
+      buffer_data_in = {4{data_in[7:0]}};
+    end else if (rst_n && state == Idle && command == 6) begin
+      buffer_write_enable = 4'b1111;
+    end else if (rst_n && state == ReadSector && byte_available) begin
+      buffer_write_enable = buffer_byte_lane;
+      buffer_data_in = {4{dout}};
+    end
+  end
+
   always_ff @(posedge clk) begin
     if (!rst_n) begin
       rd <= 0;
@@ -118,7 +160,6 @@ module sdcard #(
               buffer_index <= buffer_index + 1'b1;
             end
             3: begin  // write to buffer
-              buffer[buffer_index] <= data_in;
               buffer_index <= buffer_index + 1'b1;
             end
             4: begin  // write sector
@@ -127,6 +168,12 @@ module sdcard #(
               address <= sector << SectorToSDCardAddressShiftLeft;
               state <= PreWriteSector;
             end
+            5: begin  // advance buffer index by word
+              buffer_index <= buffer_index + 3'd4;
+            end
+            6: begin  // write word to buffer
+              buffer_index <= buffer_index + 3'd4;
+            end
             default: begin
             end
           endcase
@@ -142,7 +189,6 @@ module sdcard #(
         ReadSector: begin
 
           if (byte_available) begin
-            buffer[buffer_index] <= dout;
             buffer_index <= buffer_index + 1'b1;
           end
 
@@ -165,7 +211,7 @@ module sdcard #(
           // note: 'ready_for_next_byte' lasts for several cycles so a switch is
           //       needed to not write multiple times per 'ready_for_next_byte'
           if (ready_for_next_byte && waiting_ready_for_next_byte) begin
-            din <= buffer[buffer_index];
+            din <= data_out;
             buffer_index <= buffer_index + 1'b1;
             waiting_ready_for_next_byte <= 0;
           end
@@ -110,6 +110,17 @@ module top (
       .CacheLineIndexBitwidth(configuration::CACHE_LINE_INDEX_BITWIDTH),
       .ClockFrequencyHz(configuration::CPU_FREQUENCY_HZ),
       .BaudRate(configuration::UART_BAUD_RATE),
+      .UartRxFifoDepthBitwidth(configuration::UART_RX_FIFO_DEPTH_BITWIDTH),
+      .AddressLed(configuration::ADDRESS_LED),
+      .AddressUartOut(configuration::ADDRESS_UART_OUT),
+      .AddressUartIn(configuration::ADDRESS_UART_IN),
+      .AddressSDCardBusy(configuration::ADDRESS_SDCARD_BUSY),
+      .AddressSDCardReadSector(configuration::ADDRESS_SDCARD_READ_SECTOR),
+      .AddressSDCardNextByte(configuration::ADDRESS_SDCARD_NEXT_BYTE),
+      .AddressSDCardStatus(configuration::ADDRESS_SDCARD_STATUS),
+      .AddressSDCardWriteSector(configuration::ADDRESS_SDCARD_WRITE_SECTOR),
+      .AddressSDCardNextWord(configuration::ADDRESS_SDCARD_NEXT_WORD),
+      .AddressIOPortsStart(configuration::ADDRESS_IO_PORTS_START),
       .SDCardSimulate(0),
       .SDCardClockDivider(0)  // 0 when clk = ~30MHz
   ) ramio (